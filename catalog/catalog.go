@@ -55,7 +55,7 @@ func (c *Catalog) GetRootPageNumber(tableOrIndexName string) (int, error) {
 		return 1, nil
 	}
 	for _, o := range c.schema.objects {
-		if o.Name == tableOrIndexName {
+		if o.Name == tableOrIndexName && o.ObjectType != "stat" {
 			return o.RootPageNumber, nil
 		}
 	}
@@ -67,7 +67,7 @@ func (c *Catalog) GetColumns(tableName string) ([]string, error) {
 		return []string{"id", "type", "name", "table_name", "rootpage", "sql"}, nil
 	}
 	for _, o := range c.schema.objects {
-		if o.Name == tableName && o.TableName == tableName {
+		if o.Name == tableName && o.TableName == tableName && o.ObjectType != "stat" {
 			ts := TableSchemaFromString(o.JsonSchema)
 			ret := []string{}
 			for _, c := range ts.Columns {
@@ -84,7 +84,7 @@ func (c *Catalog) GetPrimaryKeyColumn(tableName string) (string, error) {
 		return "id", nil
 	}
 	for _, o := range c.schema.objects {
-		if o.Name == tableName && o.TableName == tableName {
+		if o.Name == tableName && o.TableName == tableName && o.ObjectType != "stat" {
 			ts := TableSchemaFromString(o.JsonSchema)
 			for _, col := range ts.Columns {
 				if col.PrimaryKey {
@@ -127,7 +127,7 @@ func (c *Catalog) GetColumnType(tableName string, columnName string) (CdbType, e
 	}
 
 	for _, o := range c.schema.objects {
-		if o.Name == tableName && o.TableName == tableName {
+		if o.Name == tableName && o.TableName == tableName && o.ObjectType != "stat" {
 			ts := TableSchemaFromString(o.JsonSchema)
 			for _, col := range ts.Columns {
 				if col.Name == columnName {
@@ -146,6 +146,17 @@ func (c *Catalog) GetColumnType(tableName string, columnName string) (CdbType, e
 	return CdbType{ID: CTUnknown}, fmt.Errorf("no type for table %s col %s", tableName, columnName)
 }
 
+// GetStats returns the statistics gathered for the table by ANALYZE or false
+// when the table has never been analyzed.
+func (c *Catalog) GetStats(tableName string) (*TableStats, bool) {
+	for _, o := range c.schema.objects {
+		if o.ObjectType == "stat" && o.TableName == tableName {
+			return TableStatsFromString(o.JsonSchema), true
+		}
+	}
+	return nil, false
+}
+
 // GetVersion returns a unique version identifier that is updated when the
 // catalog is updated.
 func (c *Catalog) GetVersion() string {
@@ -185,6 +196,36 @@ type Object struct {
 	JsonSchema string `json:"jsonSchema"`
 }
 
+// TableStats holds statistics about a table gathered by ANALYZE. The stats
+// are persisted in the schema table as the JsonSchema of a stat object and
+// used by the planner to estimate the cost of candidate access paths. The
+// stats describe the table at the time of the analyze and drift as the table
+// is written meaning they are estimates.
+type TableStats struct {
+	// RowCount is the count of rows in the table.
+	RowCount int `json:"rowCount"`
+	// LeafPages is the count of leaf pages holding the rows.
+	LeafPages int `json:"leafPages"`
+	// MinRowID is the smallest row id in the table.
+	MinRowID int `json:"minRowId"`
+	// MaxRowID is the largest row id in the table.
+	MaxRowID int `json:"maxRowId"`
+}
+
+func (ts *TableStats) ToJSON() ([]byte, error) {
+	j, err := json.Marshal(ts)
+	if err != nil {
+		return []byte{}, err
+	}
+	return j, nil
+}
+
+func TableStatsFromString(s string) *TableStats {
+	v := &TableStats{}
+	json.Unmarshal([]byte(s), &v)
+	return v
+}
+
 type TableSchema struct {
 	Columns []TableColumn `json:"columns"`
 }
@@ -15,6 +15,7 @@ type Stmt interface{}
 type StmtBase struct {
 	Explain          bool
 	ExplainQueryPlan bool
+	ExplainAnalyze   bool
 }
 
 type SelectStmt struct {
@@ -81,6 +82,33 @@ type DeleteStmt struct {
 	Predicate Expr
 }
 
+// BeginStmt opens an explicit transaction. Statements executed while the
+// transaction is open share it instead of committing individually. The
+// transaction is ended by a CommitStmt or RollbackStmt.
+type BeginStmt struct {
+	*StmtBase
+}
+
+// CommitStmt commits the open explicit transaction.
+type CommitStmt struct {
+	*StmtBase
+}
+
+// RollbackStmt rolls back the open explicit transaction.
+type RollbackStmt struct {
+	*StmtBase
+}
+
+// VacuumStmt compacts the database file by rewriting every B tree.
+type VacuumStmt struct {
+	*StmtBase
+}
+
+// AnalyzeStmt gathers table statistics for the query planner.
+type AnalyzeStmt struct {
+	*StmtBase
+}
+
 type ExprVisitor interface {
 	VisitBinaryExpr(*BinaryExpr)
 	VisitUnaryExpr(*UnaryExpr)
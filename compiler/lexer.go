@@ -3,7 +3,6 @@ package compiler
 // lexer creates tokens from a sql string. The tokens are fed into the parser.
 
 import (
-	"fmt"
 	"slices"
 	"strings"
 	"unicode"
@@ -13,11 +12,43 @@ import (
 // Statement is a individual SQL statement.
 type Statement []token
 
+// String returns the statement as normalized SQL text. The lexer collapses
+// runs of whitespace meaning statements differing only by insignificant
+// whitespace produce the same string. Literal tokens are stored unquoted so
+// their quotes are restored and embedded quotes re-escaped. Otherwise a
+// quoted literal and a numeric or identifier with the same spelling would
+// produce the same string while compiling to different plans. This makes the
+// string suitable as a cache key for the statement.
+func (s Statement) String() string {
+	size := 0
+	for _, t := range s {
+		size += len(t.value)
+		if t.tokenType == tkLiteral {
+			size += 2
+		}
+	}
+	var sb strings.Builder
+	sb.Grow(size)
+	for _, t := range s {
+		if t.tokenType == tkLiteral {
+			sb.WriteByte('\'')
+			sb.WriteString(strings.ReplaceAll(t.value, "'", "''"))
+			sb.WriteByte('\'')
+			continue
+		}
+		sb.WriteString(t.value)
+	}
+	return strings.TrimSpace(sb.String())
+}
+
 // Statements is a list of SQL statements that have been split by semi colons.
-type Statements [][]token
+type Statements []Statement
 
 type tokenType int
 
+// token is a lexed fragment of the source string. The value is a span into
+// the source rather than a copy except for keywords which share a canonical
+// constant and quoted literals containing an escaped quote.
 type token struct {
 	tokenType tokenType
 	value     string
@@ -50,29 +81,35 @@ const (
 
 // Keywords where kw is keyword
 const (
-	kwExplain = "EXPLAIN"
-	kwQuery   = "QUERY"
-	kwPlan    = "PLAN"
-	kwSelect  = "SELECT"
-	kwCount   = "COUNT"
-	kwFrom    = "FROM"
-	kwCreate  = "CREATE"
-	kwInsert  = "INSERT"
-	kwInto    = "INTO"
-	kwTable   = "TABLE"
-	kwValues  = "VALUES"
-	kwInteger = "INTEGER"
-	kwText    = "TEXT"
-	kwPrimary = "PRIMARY"
-	kwKey     = "KEY"
-	kwAs      = "AS"
-	kwWhere   = "WHERE"
-	kwIf      = "IF"
-	kwNot     = "NOT"
-	kwExists  = "EXISTS"
-	kwUpdate  = "UPDATE"
-	kwSet     = "SET"
-	kwDelete  = "DELETE"
+	kwExplain     = "EXPLAIN"
+	kwQuery       = "QUERY"
+	kwPlan        = "PLAN"
+	kwAnalyze     = "ANALYZE"
+	kwSelect      = "SELECT"
+	kwCount       = "COUNT"
+	kwFrom        = "FROM"
+	kwCreate      = "CREATE"
+	kwInsert      = "INSERT"
+	kwInto        = "INTO"
+	kwTable       = "TABLE"
+	kwValues      = "VALUES"
+	kwInteger     = "INTEGER"
+	kwText        = "TEXT"
+	kwPrimary     = "PRIMARY"
+	kwKey         = "KEY"
+	kwAs          = "AS"
+	kwWhere       = "WHERE"
+	kwIf          = "IF"
+	kwNot         = "NOT"
+	kwExists      = "EXISTS"
+	kwUpdate      = "UPDATE"
+	kwSet         = "SET"
+	kwDelete      = "DELETE"
+	kwBegin       = "BEGIN"
+	kwCommit      = "COMMIT"
+	kwRollback    = "ROLLBACK"
+	kwTransaction = "TRANSACTION"
+	kwVacuum      = "VACUUM"
 )
 
 // keywords is a list of all keywords.
@@ -80,6 +117,7 @@ var keywords = []string{
 	kwExplain,
 	kwQuery,
 	kwPlan,
+	kwAnalyze,
 	kwSelect,
 	kwCount,
 	kwFrom,
@@ -100,6 +138,11 @@ var keywords = []string{
 	kwUpdate,
 	kwSet,
 	kwDelete,
+	kwBegin,
+	kwCommit,
+	kwRollback,
+	kwTransaction,
+	kwVacuum,
 }
 
 // Operators where op is operator.
@@ -126,6 +169,43 @@ var operators = []string{
 	OpGt,
 }
 
+// keywordValues maps the exact upper and lower case spelling of each keyword
+// to its canonical upper case constant so the common spellings resolve with a
+// single map lookup instead of an upper case copy of every word.
+var keywordValues = func() map[string]string {
+	m := make(map[string]string, len(keywords)*2)
+	for _, kw := range keywords {
+		m[kw] = kw
+		m[strings.ToLower(kw)] = kw
+	}
+	return m
+}()
+
+// keywordValue returns the canonical upper case spelling of w and whether w
+// is a keyword. Mixed case spellings fall back to a case insensitive scan so
+// no path allocates.
+func keywordValue(w string) (string, bool) {
+	if kw, ok := keywordValues[w]; ok {
+		return kw, true
+	}
+	for _, kw := range keywords {
+		if strings.EqualFold(w, kw) {
+			return kw, true
+		}
+	}
+	return "", false
+}
+
+// operatorRunes holds the first rune of each operator so the operator check
+// does not rebuild the set for every token.
+var operatorRunes = func() []rune {
+	ros := []rune{}
+	for _, op := range operators {
+		ros = append(ros, rune(op[0]))
+	}
+	return ros
+}()
+
 // opPrecedence defines operator precedence. The higher the number the higher
 // the precedence.
 var opPrecedence = map[string]int{
@@ -154,7 +234,7 @@ func NewLexer(src string) *lexer {
 // statement is terminated by a semi colon.
 func (l *lexer) ToStatements() Statements {
 	tokens := l.Lex()
-	statements := [][]token{}
+	statements := Statements{}
 	start := 0
 	for i := range tokens {
 		if tokens[i].value == ";" {
@@ -203,7 +283,9 @@ func IsTerminated(statements Statements) bool {
 
 // Lex tokenizes the src string.
 func (l *lexer) Lex() []token {
-	ret := []token{}
+	// A token spans a few source bytes on average so this capacity mostly
+	// avoids regrowing the slice.
+	ret := make([]token, 0, len(l.src)/4+1)
 	for {
 		t := l.getToken()
 		if t.tokenType == tkEOF {
@@ -271,8 +353,8 @@ func (l *lexer) scanWord() token {
 		l.next()
 	}
 	value := l.src[l.start:l.end]
-	if l.isKeyword(value) {
-		return token{tokenType: tkKeyword, value: strings.ToUpper(value)}
+	if kw, ok := keywordValue(value); ok {
+		return token{tokenType: tkKeyword, value: kw}
 	}
 	return token{tokenType: tkIdentifier, value: value}
 }
@@ -292,8 +374,10 @@ func (l *lexer) scanSeparator() token {
 
 func (l *lexer) scanLiteral(quote rune) token {
 	l.next()
+	escaped := false
 	for {
 		if l.peek(l.end) == quote && l.peek(l.end+1) == quote {
+			escaped = true
 			l.next()
 			l.next()
 			continue
@@ -304,11 +388,12 @@ func (l *lexer) scanLiteral(quote rune) token {
 		l.next()
 	}
 	l.next()
-	v := strings.ReplaceAll(
-		l.src[l.start+1:l.end-1],
-		fmt.Sprintf("%c%c", quote, quote),
-		fmt.Sprintf("%c", quote),
-	)
+	v := l.src[l.start+1 : l.end-1]
+	if escaped {
+		// Only a literal containing an escaped quote pays for a copy. Every
+		// other literal is a span into the source.
+		v = strings.ReplaceAll(v, string([]rune{quote, quote}), string(quote))
+	}
 	return token{tokenType: tkLiteral, value: v}
 }
 
@@ -385,17 +470,8 @@ func (*lexer) isDoubleQuote(r rune) bool {
 	return r == '"'
 }
 
-func (*lexer) isKeyword(w string) bool {
-	uw := strings.ToUpper(w)
-	return slices.Contains(keywords, uw)
-}
-
 func (*lexer) isOperator(o rune) bool {
-	ros := []rune{}
-	for _, op := range operators {
-		ros = append(ros, rune(op[0]))
-	}
-	return slices.Contains(ros, o)
+	return slices.Contains(operatorRunes, o)
 }
 
 func (*lexer) isParam(r rune) bool {
@@ -51,6 +51,18 @@ func TestLexSelect(t *testing.T) {
 				{tkIdentifier, "foo"},
 			},
 		},
+		{
+			sql: "SeLeCt * FrOm foo",
+			expected: []token{
+				{tkKeyword, "SELECT"},
+				{tkWhitespace, " "},
+				{tkOperator, "*"},
+				{tkWhitespace, " "},
+				{tkKeyword, "FROM"},
+				{tkWhitespace, " "},
+				{tkIdentifier, "foo"},
+			},
+		},
 		{
 			sql: `
 				select *
@@ -53,6 +53,9 @@ func (p *parser) parseStmt() (Stmt, error) {
 			} else {
 				return nil, fmt.Errorf(tokenErr, p.tokens[p.end].value)
 			}
+		} else if nv.value == kwAnalyze {
+			sb.ExplainAnalyze = true
+			t = p.nextNonSpace()
 		} else {
 			sb.Explain = true
 			t = nv
@@ -69,10 +72,51 @@ func (p *parser) parseStmt() (Stmt, error) {
 		return p.parseUpdate(sb)
 	case kwDelete:
 		return p.parseDelete(sb)
+	case kwBegin:
+		return p.parseBegin(sb)
+	case kwCommit:
+		return p.parseCommit(sb)
+	case kwRollback:
+		return p.parseRollback(sb)
+	case kwVacuum:
+		return p.parseVacuum(sb)
+	case kwAnalyze:
+		return p.parseAnalyze(sb)
 	}
 	return nil, fmt.Errorf(tokenErr, t.value)
 }
 
+func (p *parser) parseBegin(sb *StmtBase) (*BeginStmt, error) {
+	p.skipTransactionKeyword()
+	return &BeginStmt{StmtBase: sb}, nil
+}
+
+func (p *parser) parseCommit(sb *StmtBase) (*CommitStmt, error) {
+	p.skipTransactionKeyword()
+	return &CommitStmt{StmtBase: sb}, nil
+}
+
+func (p *parser) parseRollback(sb *StmtBase) (*RollbackStmt, error) {
+	p.skipTransactionKeyword()
+	return &RollbackStmt{StmtBase: sb}, nil
+}
+
+func (p *parser) parseVacuum(sb *StmtBase) (*VacuumStmt, error) {
+	return &VacuumStmt{StmtBase: sb}, nil
+}
+
+func (p *parser) parseAnalyze(sb *StmtBase) (*AnalyzeStmt, error) {
+	return &AnalyzeStmt{StmtBase: sb}, nil
+}
+
+// skipTransactionKeyword consumes the optional TRANSACTION keyword in BEGIN,
+// COMMIT, and ROLLBACK statements.
+func (p *parser) skipTransactionKeyword() {
+	if p.peekNextNonSpace().value == kwTransaction {
+		p.nextNonSpace()
+	}
+}
+
 func (p *parser) parseSelect(sb *StmtBase) (*SelectStmt, error) {
 	stmt := &SelectStmt{StmtBase: sb}
 	if p.tokens[p.end].value != kwSelect {
@@ -73,6 +73,35 @@ func TestParseSelect(t *testing.T) {
 				},
 			},
 		},
+		{
+			name: "with explain analyze",
+			tokens: []token{
+				{tkKeyword, "EXPLAIN"},
+				{tkWhitespace, " "},
+				{tkKeyword, "ANALYZE"},
+				{tkWhitespace, " "},
+				{tkKeyword, "SELECT"},
+				{tkWhitespace, " "},
+				{tkOperator, "*"},
+				{tkWhitespace, " "},
+				{tkKeyword, "FROM"},
+				{tkWhitespace, " "},
+				{tkIdentifier, "foo"},
+			},
+			expect: &SelectStmt{
+				StmtBase: &StmtBase{
+					ExplainAnalyze: true,
+				},
+				From: &From{
+					TableName: "foo",
+				},
+				ResultColumns: []ResultColumn{
+					{
+						All: true,
+					},
+				},
+			},
+		},
 		{
 			name: "with where clause",
 			tokens: []token{
@@ -16,6 +16,7 @@ import (
 
 type executor interface {
 	Execute(*vm.ExecutionPlan, []any) *vm.ExecuteResult
+	ExecuteRows(*vm.ExecutionPlan, []any, func([]*string) error) *vm.ExecuteResult
 }
 
 type statementPlanner interface {
@@ -30,11 +31,15 @@ type dbCatalog interface {
 	TableExists(string) bool
 	GetVersion() string
 	GetPrimaryKeyColumn(string) (string, error)
+	GetStats(string) (*catalog.TableStats, bool)
 }
 
 type DB struct {
-	vm        executor
-	catalog   dbCatalog
+	vm      executor
+	catalog dbCatalog
+	// planCache holds compiled execution plans keyed by normalized SQL text
+	// so repeated statements skip the lexer, parser, and planner.
+	planCache *planCache
 	UseMemory bool
 }
 
@@ -46,16 +51,28 @@ func New(useMemory bool, filename string) (*DB, error) {
 	return &DB{
 		vm:        vm.New(kv),
 		catalog:   kv.GetCatalog(),
+		planCache: newPlanCache(),
 		UseMemory: useMemory,
 	}, nil
 }
 
+// PreparedStatement is a statement with bindable arguments and a row cursor.
+// The result rows stream from the vm as Step advances so memory stays bounded
+// by a single row. The statement holds its transaction until the rows are
+// exhausted or the statement is closed.
 type PreparedStatement struct {
 	Statement compiler.Statement
 	Args      []any
 	DB        *DB
-	Result    *vm.ExecuteResult
-	ResultIdx int
+	// rows streams the rows of the executing statement.
+	rows *Rows
+	// row is the row the cursor is currently on.
+	row []*string
+	// pending holds the row read ahead by Execute so fast failures surface
+	// before the first Step.
+	pending []*string
+	// hasPending is true when pending holds a row.
+	hasPending bool
 }
 
 func (db *DB) NewPreparedStatement(sql string) (*PreparedStatement, error) {
@@ -67,10 +84,75 @@ func (db *DB) NewPreparedStatement(sql string) (*PreparedStatement, error) {
 		Statement: statements[0],
 		Args:      []any{},
 		DB:        db,
-		ResultIdx: -1,
 	}, nil
 }
 
+// BindInt binds an int as the next available argument. The value is stored in
+// the vm's normalized integer representation so execution does not convert it
+// again.
+func (p *PreparedStatement) BindInt(i int) {
+	p.Args = append(p.Args, i)
+}
+
+// BindString binds a string as the next available argument.
+func (p *PreparedStatement) BindString(s string) {
+	p.Args = append(p.Args, s)
+}
+
+// Execute begins executing the prepared statement. One row is read ahead so
+// errors raised before the first row, like compile errors, are visible to Err
+// immediately. Errors raised mid stream surface once Step reaches them.
+func (p *PreparedStatement) Execute() {
+	p.rows = p.DB.ExecuteRows(p.Statement, p.Args)
+	p.pending, p.hasPending = p.rows.Next()
+}
+
+// Err returns the error the executing statement has encountered so far.
+func (p *PreparedStatement) Err() error {
+	if p.rows == nil {
+		return nil
+	}
+	return p.rows.Err()
+}
+
+// Step advances the cursor to the next result row and reports whether one
+// exists.
+func (p *PreparedStatement) Step() bool {
+	if p.hasPending {
+		p.row = p.pending
+		p.pending = nil
+		p.hasPending = false
+		return true
+	}
+	var ok bool
+	p.row, ok = p.rows.Next()
+	return ok
+}
+
+// Column returns the value of the current row at the given column index. The
+// value is nil when the column is null.
+func (p *PreparedStatement) Column(i int) *string {
+	return p.row[i]
+}
+
+// ColumnNames returns the names of the result columns.
+func (p *PreparedStatement) ColumnNames() []string {
+	return p.rows.Header()
+}
+
+// ColumnTypes returns the types of the result columns.
+func (p *PreparedStatement) ColumnTypes() []catalog.CdbType {
+	return p.rows.Types()
+}
+
+// Close releases the rows of the executing statement and the transaction they
+// hold. A prepared statement can be executed again after being closed.
+func (p *PreparedStatement) Close() {
+	if p.rows != nil {
+		p.rows.Close()
+	}
+}
+
 // Tokenize makes a raw sql string into a slice of tokens. Otherwise known as
 // lexing.
 func (db *DB) Tokenize(sql string) compiler.Statements {
@@ -85,7 +167,37 @@ func (db *DB) IsTerminated(statements compiler.Statements) bool {
 
 // Execute executes the given statements with the given params.
 func (db *DB) Execute(statements compiler.Statement, params []any) vm.ExecuteResult {
+	return db.execute(statements, params, nil, nil)
+}
+
+// execute compiles and runs the given statement. A non nil yield streams each
+// result row to the caller as the vm produces it instead of materializing the
+// result. A non nil onHeader is called with the result header and types once
+// the plan is known and before any row is yielded. A recompile after a version
+// change can call onHeader again, but always before the first row since the
+// version check happens when the plan opens its transaction.
+func (db *DB) execute(
+	statements compiler.Statement,
+	params []any,
+	onHeader func([]string, []catalog.CdbType),
+	yield func([]*string) error,
+) vm.ExecuteResult {
 	start := time.Now()
+	key := statements.String()
+	if plan, hit := db.planCache.Get(key, db.catalog.GetVersion()); hit {
+		if onHeader != nil {
+			onHeader(plan.ResultHeader, headerTypes(plan, params))
+		}
+		executeResult := *db.vm.ExecuteRows(plan, params, yield)
+		if !errors.Is(executeResult.Err, vm.ErrVersionChanged) {
+			executeResult.Duration = time.Since(start)
+			return executeResult
+		}
+		// The catalog version changed between the cache lookup and the
+		// execution. Evict the plan and compile as if the lookup missed.
+		db.planCache.Remove(key)
+	}
+
 	statement, err := compiler.NewParser(statements).Parse()
 	if err != nil {
 		return vm.ExecuteResult{Err: err}
@@ -108,15 +220,34 @@ func (db *DB) Execute(statements compiler.Statement, params []any) vm.ExecuteRes
 		if err != nil {
 			return vm.ExecuteResult{Err: err}
 		}
-		executeResult = *db.vm.Execute(executionPlan, params)
+		if onHeader != nil {
+			onHeader(executionPlan.ResultHeader, headerTypes(executionPlan, params))
+		}
+		executeResult = *db.vm.ExecuteRows(executionPlan, params, yield)
 		if !errors.Is(executeResult.Err, vm.ErrVersionChanged) {
+			if executeResult.Err == nil && !executionPlan.Explain {
+				db.planCache.Add(key, executionPlan)
+			}
 			break
 		}
+		// Recompiling with a fresh planner picks up the new catalog version
+		// since a planner compiles against the version it was created with.
+		planner = db.getPlannerFor(statement)
 	}
 	executeResult.Duration = time.Since(start)
 	return executeResult
 }
 
+// headerTypes resolves variable result types from the bound params for the
+// header callback. A resolution failure falls back to the unresolved types
+// and is left to the vm to surface as the execution error.
+func headerTypes(plan *vm.ExecutionPlan, params []any) []catalog.CdbType {
+	if resolved, err := plan.ResolveTypes(params); err == nil {
+		return resolved
+	}
+	return plan.ResultTypes
+}
+
 func (db *DB) getPlannerFor(statement compiler.Stmt) statementPlanner {
 	switch s := statement.(type) {
 	case *compiler.SelectStmt:
@@ -129,6 +260,16 @@ func (db *DB) getPlannerFor(statement compiler.Stmt) statementPlanner {
 		return planner.NewUpdate(db.catalog, s)
 	case *compiler.DeleteStmt:
 		return planner.NewDelete(db.catalog, s)
+	case *compiler.BeginStmt:
+		return planner.NewBegin(db.catalog, s)
+	case *compiler.CommitStmt:
+		return planner.NewCommit(db.catalog, s)
+	case *compiler.RollbackStmt:
+		return planner.NewRollback(db.catalog, s)
+	case *compiler.VacuumStmt:
+		return planner.NewVacuum(db.catalog, s)
+	case *compiler.AnalyzeStmt:
+		return planner.NewAnalyze(db.catalog, s)
 	}
 	panic("statement not supported")
 }
@@ -0,0 +1,83 @@
+package db
+
+import (
+	"fmt"
+	"strings"
+	"testing"
+)
+
+// benchRows is the size of the dataset the sql benchmarks run against.
+const benchRows = 1_000
+
+func mustExecuteB(b *testing.B, db *DB, sql string) {
+	statements := db.Tokenize(sql)
+	res := db.Execute(statements[0], []any{})
+	if res.Err != nil {
+		b.Fatalf("%s executing sql: %s", res.Err, sql)
+	}
+}
+
+// benchDB seeds a database with benchRows people so each benchmark runs
+// against the same fixed dataset.
+func benchDB(b *testing.B) *DB {
+	db, err := New(true, "")
+	if err != nil {
+		b.Fatal(err)
+	}
+	mustExecuteB(b, db, "CREATE TABLE person (id INTEGER PRIMARY KEY, first_name TEXT, last_name TEXT, age INTEGER)")
+	values := make([]string, benchRows)
+	for i := 0; i < benchRows; i += 1 {
+		values[i] = fmt.Sprintf("('first%d', 'last%d', %d)", i, i, i%100)
+	}
+	mustExecuteB(b, db, "INSERT INTO person (first_name, last_name, age) VALUES "+strings.Join(values, ","))
+	return db
+}
+
+// BenchmarkSelectPoint measures a parameterized primary key lookup round trip
+// including the plan cache hit and parameter binding.
+func BenchmarkSelectPoint(b *testing.B) {
+	db := benchDB(b)
+	statements := db.Tokenize("SELECT * FROM person WHERE id = ?")
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		res := db.Execute(statements[0], []any{i%benchRows + 1})
+		if res.Err != nil {
+			b.Fatal(res.Err)
+		}
+		if len(res.ResultRows) != 1 {
+			b.Fatalf("expected 1 row got %d", len(res.ResultRows))
+		}
+	}
+}
+
+// BenchmarkSelectScan measures a full table scan round trip.
+func BenchmarkSelectScan(b *testing.B) {
+	db := benchDB(b)
+	statements := db.Tokenize("SELECT * FROM person")
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		res := db.Execute(statements[0], []any{})
+		if res.Err != nil {
+			b.Fatal(res.Err)
+		}
+		if len(res.ResultRows) != benchRows {
+			b.Fatalf("expected %d rows got %d", benchRows, len(res.ResultRows))
+		}
+	}
+}
+
+// BenchmarkInsert measures a parameterized single row insert round trip.
+func BenchmarkInsert(b *testing.B) {
+	db := benchDB(b)
+	statements := db.Tokenize("INSERT INTO person (first_name, last_name, age) VALUES (?, ?, ?)")
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		res := db.Execute(statements[0], []any{"first", "last", 30})
+		if res.Err != nil {
+			b.Fatal(res.Err)
+		}
+	}
+}
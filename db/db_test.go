@@ -1,7 +1,9 @@
 package db
 
 import (
+	"fmt"
 	"strconv"
+	"strings"
 	"testing"
 
 	"github.com/chirst/cdb/catalog"
@@ -206,6 +208,36 @@ func TestSelectRangeWithWhere(t *testing.T) {
 	}
 }
 
+func TestSelectPrimaryKeyRange(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE test (id INTEGER PRIMARY KEY, val INTEGER)")
+	mustExecute(t, db, "INSERT INTO test (id, val) VALUES (1, 10), (2, 20), (3, 30), (4, 40)")
+
+	// A lower bound seeks past the first rows.
+	res := mustExecute(t, db, "SELECT * FROM test WHERE id > 2")
+	if rowCount := len(res.ResultRows); rowCount != 2 {
+		t.Fatalf("want 2 rows but got %d", rowCount)
+	}
+	if got := *res.ResultRows[0][0]; got != "3" {
+		t.Fatalf("want 3 but got %s", got)
+	}
+
+	// An upper bound terminates the scan early.
+	res = mustExecute(t, db, "SELECT * FROM test WHERE id < 3")
+	if rowCount := len(res.ResultRows); rowCount != 2 {
+		t.Fatalf("want 2 rows but got %d", rowCount)
+	}
+	if got := *res.ResultRows[1][0]; got != "2" {
+		t.Fatalf("want 2 but got %s", got)
+	}
+
+	// A bound excluding every row returns no rows.
+	res = mustExecute(t, db, "SELECT * FROM test WHERE id > 4")
+	if rowCount := len(res.ResultRows); rowCount != 0 {
+		t.Fatalf("want 0 rows but got %d", rowCount)
+	}
+}
+
 func TestResultColumnExprs(t *testing.T) {
 	type rcCase struct {
 		statement string
@@ -420,3 +452,240 @@ func TestDeleteStatementWithWhere(t *testing.T) {
 		t.Fatalf("expected %s but got %s", want2, got2)
 	}
 }
+
+func TestPlanCache(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a INTEGER);")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES (1), (2);")
+	selectSql := "SELECT * FROM foo;"
+	mustExecute(t, db, selectSql)
+	key := db.Tokenize(selectSql)[0].String()
+	cached, hit := db.planCache.Get(key, db.catalog.GetVersion())
+	if !hit {
+		t.Fatal("expected select plan to be cached")
+	}
+	res := mustExecute(t, db, selectSql)
+	if lrr := len(res.ResultRows); lrr != 2 {
+		t.Fatalf("expected 2 rows but got %d", lrr)
+	}
+	mustExecute(t, db, "CREATE TABLE bar (id INTEGER PRIMARY KEY);")
+	if _, hit := db.planCache.Get(key, db.catalog.GetVersion()); hit {
+		t.Fatal("expected plan to be evicted after the catalog changed")
+	}
+	res = mustExecute(t, db, selectSql)
+	if lrr := len(res.ResultRows); lrr != 2 {
+		t.Fatalf("expected 2 rows but got %d", lrr)
+	}
+	recompiled, hit := db.planCache.Get(key, db.catalog.GetVersion())
+	if !hit {
+		t.Fatal("expected select plan to be cached after recompiling")
+	}
+	if recompiled == cached {
+		t.Fatal("expected a recompiled plan not the stale plan")
+	}
+}
+
+func TestPlanCacheLiteralKey(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a TEXT);")
+	// A quoted literal and a numeric with the same spelling compile to
+	// different plans so the two forms must not share a cache entry.
+	quoted := "INSERT INTO foo (a) VALUES ('1');"
+	numeric := "INSERT INTO foo (a) VALUES (1);"
+	quotedKey := db.Tokenize(quoted)[0].String()
+	numericKey := db.Tokenize(numeric)[0].String()
+	if quotedKey == numericKey {
+		t.Fatalf("expected distinct cache keys got %q for both forms", quotedKey)
+	}
+	mustExecute(t, db, quoted)
+	if _, hit := db.planCache.Get(quotedKey, db.catalog.GetVersion()); !hit {
+		t.Fatal("expected quoted insert plan to be cached")
+	}
+	if _, hit := db.planCache.Get(numericKey, db.catalog.GetVersion()); hit {
+		t.Fatal("expected numeric insert to not hit the quoted insert's entry")
+	}
+	// An embedded quote is re-escaped in the key so it cannot run together
+	// with the text around it.
+	escapedKey := db.Tokenize("SELECT '''1';")[0].String()
+	if want := "SELECT '''1';"; escapedKey != want {
+		t.Fatalf("expected key %q got %q", want, escapedKey)
+	}
+}
+
+func TestExplainAnalyze(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a INTEGER);")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES (1), (2), (3);")
+	res := mustExecute(t, db, "EXPLAIN ANALYZE SELECT * FROM foo;")
+	expectedHeader := []string{"addr", "opcode", "count", "time", "comment"}
+	for i, h := range expectedHeader {
+		if got := res.ResultHeader[i]; got != h {
+			t.Fatalf("expected header %s got %s", h, got)
+		}
+	}
+	nextCount := ""
+	for _, row := range res.ResultRows {
+		if *row[1] == "Next" {
+			nextCount = *row[2]
+		}
+	}
+	if nextCount != "3" {
+		t.Fatalf("expected Next to be counted 3 times got %s", nextCount)
+	}
+	last := res.ResultRows[len(res.ResultRows)-1]
+	if *last[1] != "PageCacheMiss" {
+		t.Fatalf("expected a page cache row got %s", *last[1])
+	}
+}
+
+func TestExplicitTransaction(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a INTEGER);")
+
+	mustExecute(t, db, "BEGIN;")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES (1), (2);")
+	res := mustExecute(t, db, "SELECT * FROM foo;")
+	if lrr := len(res.ResultRows); lrr != 2 {
+		t.Fatalf("expected transaction to see its own writes got %d rows", lrr)
+	}
+	mustExecute(t, db, "COMMIT;")
+	res = mustExecute(t, db, "SELECT * FROM foo;")
+	if lrr := len(res.ResultRows); lrr != 2 {
+		t.Fatalf("expected 2 rows after commit got %d", lrr)
+	}
+
+	mustExecute(t, db, "BEGIN TRANSACTION;")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES (3);")
+	mustExecute(t, db, "ROLLBACK;")
+	res = mustExecute(t, db, "SELECT * FROM foo;")
+	if lrr := len(res.ResultRows); lrr != 2 {
+		t.Fatalf("expected rollback to discard the insert got %d rows", lrr)
+	}
+
+	statements := db.Tokenize("COMMIT;")
+	if err := db.Execute(statements[0], []any{}).Err; err == nil {
+		t.Fatal("expected commit without an open transaction to error")
+	}
+}
+
+func TestExecuteMissingParameter(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY)")
+	statements := db.Tokenize("SELECT * FROM foo WHERE id = ?")
+	res := db.Execute(statements[0], []any{})
+	if res.Err == nil {
+		t.Fatal("expected err for unbound parameter")
+	}
+}
+
+func TestAnalyze(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a TEXT);")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES ('a'), ('b'), ('c');")
+
+	mustExecute(t, db, "ANALYZE;")
+
+	res := mustExecute(t, db, "SELECT type FROM cdb_schema;")
+	statRows := 0
+	for _, row := range res.ResultRows {
+		if *row[0] == "stat" {
+			statRows += 1
+		}
+	}
+	if statRows != 1 {
+		t.Fatalf("expected 1 stat row after analyze got %d", statRows)
+	}
+
+	// Analyzing again updates the stat row in place instead of adding another.
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES ('d');")
+	mustExecute(t, db, "ANALYZE;")
+	res = mustExecute(t, db, "SELECT type FROM cdb_schema;")
+	statRows = 0
+	for _, row := range res.ResultRows {
+		if *row[0] == "stat" {
+			statRows += 1
+		}
+	}
+	if statRows != 1 {
+		t.Fatalf("expected 1 stat row after second analyze got %d", statRows)
+	}
+
+	// With statistics the cost model keeps the full scan for a range covering
+	// the whole of a small table since the descent to the lower bound buys
+	// nothing.
+	res = mustExecute(t, db, "EXPLAIN QUERY PLAN SELECT * FROM foo WHERE id > 0;")
+	if !strings.Contains(res.Text, "scan table foo") {
+		t.Fatalf("expected full scan for whole table range got plan:\n%s", res.Text)
+	}
+
+	// The stat objects do not shadow the tables they describe.
+	res = mustExecute(t, db, "SELECT COUNT(*) FROM foo;")
+	if c := res.ResultRows[0][0]; *c != "4" {
+		t.Fatalf("expected 4 rows after analyze got %s", *c)
+	}
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES ('e');")
+	res = mustExecute(t, db, "SELECT a FROM foo WHERE id = 5;")
+	if v := res.ResultRows[0][0]; *v != "e" {
+		t.Fatalf("expected insert after analyze to be readable got %s", *v)
+	}
+}
+
+func TestVacuum(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a TEXT);")
+	mustExecute(t, db, "CREATE TABLE bar (id INTEGER PRIMARY KEY, b INTEGER);")
+	bigValue := strings.Repeat("x", 10_000)
+	for i := 1; i <= 100; i += 1 {
+		mustExecute(t, db, fmt.Sprintf("INSERT INTO foo (a) VALUES ('v%d');", i))
+	}
+	mustExecute(t, db, fmt.Sprintf("INSERT INTO foo (a) VALUES ('%s');", bigValue))
+	mustExecute(t, db, "INSERT INTO bar (b) VALUES (1), (2), (3);")
+	mustExecute(t, db, "DELETE FROM foo WHERE id < 51;")
+
+	mustExecute(t, db, "VACUUM;")
+
+	res := mustExecute(t, db, "SELECT COUNT(*) FROM foo;")
+	if c := res.ResultRows[0][0]; *c != "51" {
+		t.Fatalf("expected 51 rows after vacuum got %s", *c)
+	}
+	res = mustExecute(t, db, "SELECT a FROM foo WHERE id = 101;")
+	if v := res.ResultRows[0][0]; *v != bigValue {
+		t.Fatal("expected large value to survive vacuum")
+	}
+	res = mustExecute(t, db, "SELECT * FROM bar;")
+	if lrr := len(res.ResultRows); lrr != 3 {
+		t.Fatalf("expected 3 rows after vacuum got %d", lrr)
+	}
+	// The vacuumed tables accept new writes against their rebuilt trees.
+	mustExecute(t, db, "INSERT INTO bar (b) VALUES (4);")
+	res = mustExecute(t, db, "SELECT COUNT(*) FROM bar;")
+	if c := res.ResultRows[0][0]; *c != "4" {
+		t.Fatalf("expected 4 rows after insert got %s", *c)
+	}
+}
+
+func TestVacuumAfterAnalyze(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, a TEXT);")
+	mustExecute(t, db, "INSERT INTO foo (a) VALUES ('a'), ('b'), ('c');")
+	mustExecute(t, db, "ANALYZE;")
+
+	// The stat rows written by analyze have no tree so the vacuum must carry
+	// them through the schema rewrite instead of copying a tree rooted at 0.
+	mustExecute(t, db, "VACUUM;")
+
+	res := mustExecute(t, db, "SELECT COUNT(*) FROM foo;")
+	if c := res.ResultRows[0][0]; *c != "3" {
+		t.Fatalf("expected 3 rows after vacuum got %s", *c)
+	}
+	res = mustExecute(t, db, "SELECT type FROM cdb_schema;")
+	statRows := 0
+	for _, row := range res.ResultRows {
+		if *row[0] == "stat" {
+			statRows += 1
+		}
+	}
+	if statRows != 1 {
+		t.Fatalf("expected 1 stat row after vacuum got %d", statRows)
+	}
+}
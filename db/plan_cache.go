@@ -0,0 +1,139 @@
+package db
+
+import (
+	"sync"
+
+	"github.com/chirst/cdb/vm"
+)
+
+// planCacheMaxSize is the maximum count of compiled plans kept in the plan
+// cache before the least recently used plan is evicted.
+const planCacheMaxSize = 512
+
+// planCacheEntry is a node in the intrusive doubly linked eviction list. Each
+// cached plan carries its own list pointers so get, add, and evict are all
+// O(1).
+type planCacheEntry struct {
+	key  string
+	plan *vm.ExecutionPlan
+	prev *planCacheEntry
+	next *planCacheEntry
+}
+
+// planCache is a LRU (least recently used) cache of compiled execution plans
+// keyed by normalized SQL text. Repeated executions of the same statement skip
+// the lexer, parser, and planner entirely. A cached plan carries the catalog
+// version it was compiled with meaning a plan compiled against an out of date
+// catalog misses and is recompiled.
+type planCache struct {
+	// mu guards the cache since the db can be shared across goroutines.
+	mu    sync.Mutex
+	cache map[string]*planCacheEntry
+	// head is the most recently used entry of the eviction list. tail is the
+	// least recently used entry and is the next entry to be evicted.
+	head *planCacheEntry
+	tail *planCacheEntry
+	// maxSize is the maximum count of plans that can be cached.
+	maxSize int
+}
+
+func newPlanCache() *planCache {
+	return &planCache{
+		cache:   map[string]*planCacheEntry{},
+		maxSize: planCacheMaxSize,
+	}
+}
+
+// Get returns the cached plan for the key when the plan was compiled with the
+// given catalog version. A plan compiled with a different version is evicted
+// and reported as a miss so the caller recompiles.
+func (c *planCache) Get(key string, version string) (*vm.ExecutionPlan, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	e, ok := c.cache[key]
+	if !ok {
+		return nil, false
+	}
+	if e.plan.Version != version {
+		delete(c.cache, key)
+		c.unlink(e)
+		return nil, false
+	}
+	c.prioritize(e)
+	return e.plan, true
+}
+
+// Add adds the plan to the cache and prioritizes it. If a collision occurs,
+// the key will be prioritized and the plan will be updated.
+func (c *planCache) Add(key string, plan *vm.ExecutionPlan) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if e, ok := c.cache[key]; ok {
+		e.plan = plan
+		c.prioritize(e)
+		return
+	}
+	e := &planCacheEntry{
+		key:  key,
+		plan: plan,
+	}
+	c.cache[key] = e
+	c.pushFront(e)
+	if len(c.cache) > c.maxSize {
+		c.evict()
+	}
+}
+
+// Remove removes the key from the cache. If the key is not found it will be
+// ignored.
+func (c *planCache) Remove(key string) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if e, ok := c.cache[key]; ok {
+		delete(c.cache, key)
+		c.unlink(e)
+	}
+}
+
+// prioritize moves the entry to the front of the eviction list making it the
+// most recently used entry.
+func (c *planCache) prioritize(e *planCacheEntry) {
+	if c.head == e {
+		return
+	}
+	c.unlink(e)
+	c.pushFront(e)
+}
+
+func (c *planCache) evict() {
+	e := c.tail
+	c.unlink(e)
+	delete(c.cache, e.key)
+}
+
+func (c *planCache) pushFront(e *planCacheEntry) {
+	e.prev = nil
+	e.next = c.head
+	if c.head != nil {
+		c.head.prev = e
+	}
+	c.head = e
+	if c.tail == nil {
+		c.tail = e
+	}
+}
+
+func (c *planCache) unlink(e *planCacheEntry) {
+	if e.prev != nil {
+		e.prev.next = e.next
+	} else {
+		c.head = e.next
+	}
+	if e.next != nil {
+		e.next.prev = e.prev
+	} else {
+		c.tail = e.prev
+	}
+	e.prev = nil
+	e.next = nil
+}
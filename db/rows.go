@@ -0,0 +1,158 @@
+package db
+
+import (
+	"errors"
+
+	"github.com/chirst/cdb/catalog"
+	"github.com/chirst/cdb/compiler"
+	"github.com/chirst/cdb/vm"
+)
+
+// errRowsClosed stops an execution whose consumer closed the rows early. An
+// early close is not a failure so the error is filtered out of the final
+// result.
+var errRowsClosed = errors.New("rows closed")
+
+// rowsHeader carries the result column names and types for a streaming
+// execution.
+type rowsHeader struct {
+	columns []string
+	types   []catalog.CdbType
+}
+
+// Rows streams the rows of a single statement as the vm produces them. Memory
+// is bounded by one row instead of the whole result. The statement executes
+// concurrently and holds its transaction until the rows are exhausted or Close
+// is called, so a Rows must always be drained or closed before another
+// statement needs a conflicting transaction.
+type Rows struct {
+	headerCh chan rowsHeader
+	header   rowsHeader
+	// gotHeader is true once header holds the value read from headerCh.
+	gotHeader bool
+	rowCh     chan []*string
+	cancelCh  chan struct{}
+	resultCh  chan vm.ExecuteResult
+	// result holds the final execute result once the execution has finished.
+	result *vm.ExecuteResult
+	closed bool
+}
+
+// ExecuteRows executes the given statement like Execute except the result rows
+// are streamed through the returned Rows instead of being materialized.
+func (db *DB) ExecuteRows(statements compiler.Statement, params []any) *Rows {
+	r := &Rows{
+		headerCh: make(chan rowsHeader, 1),
+		rowCh:    make(chan []*string),
+		cancelCh: make(chan struct{}),
+		resultCh: make(chan vm.ExecuteResult, 1),
+	}
+	onHeader := func(columns []string, types []catalog.CdbType) {
+		// Keep the latest header. A recompile after a version change can
+		// produce a new header, but always before any row is delivered.
+		select {
+		case <-r.headerCh:
+		default:
+		}
+		r.headerCh <- rowsHeader{columns: columns, types: types}
+	}
+	yield := func(row []*string) error {
+		select {
+		case r.rowCh <- row:
+			return nil
+		case <-r.cancelCh:
+			return errRowsClosed
+		}
+	}
+	go func() {
+		res := db.execute(statements, params, onHeader, yield)
+		// Explain and analyze plans materialize their rows in the final
+		// result rather than streaming them. Feed those through the row
+		// channel so every result reads the same way.
+		for _, row := range res.ResultRows {
+			if yield(row) != nil {
+				break
+			}
+		}
+		res.ResultRows = nil
+		if errors.Is(res.Err, errRowsClosed) {
+			res.Err = nil
+		}
+		close(r.rowCh)
+		r.resultCh <- res
+		close(r.headerCh)
+	}()
+	return r
+}
+
+// Header returns the result column names. Header blocks until the statement
+// has compiled.
+func (r *Rows) Header() []string {
+	return r.waitHeader().columns
+}
+
+// Types returns the result column types. Like Header it blocks until the
+// statement has compiled.
+func (r *Rows) Types() []catalog.CdbType {
+	return r.waitHeader().types
+}
+
+func (r *Rows) waitHeader() rowsHeader {
+	if !r.gotHeader {
+		if h, ok := <-r.headerCh; ok {
+			r.header = h
+			r.gotHeader = true
+		}
+	}
+	return r.header
+}
+
+// Next returns the next row and true until the rows are exhausted. Once Next
+// returns false the execution has finished and Err holds its error.
+func (r *Rows) Next() ([]*string, bool) {
+	row, ok := <-r.rowCh
+	if !ok {
+		r.finish()
+		return nil, false
+	}
+	return row, true
+}
+
+// Close stops the execution and releases its transaction. Close is a no op
+// when the rows are already exhausted or closed.
+func (r *Rows) Close() {
+	if r.closed {
+		return
+	}
+	r.closed = true
+	close(r.cancelCh)
+	for range r.rowCh {
+	}
+	r.finish()
+}
+
+// Err returns the execution error. Err is nil until the rows have been
+// exhausted or closed since a streaming execution can fail after delivering
+// rows.
+func (r *Rows) Err() error {
+	if r.result == nil {
+		return nil
+	}
+	return r.result.Err
+}
+
+// Result returns the final execute result with the rows stripped out. Result
+// must only be called once the rows have been exhausted or closed since it
+// blocks until the execution finishes.
+func (r *Rows) Result() *vm.ExecuteResult {
+	r.finish()
+	return r.result
+}
+
+// finish records the final execute result once the row channel has closed.
+func (r *Rows) finish() {
+	if r.result == nil {
+		res := <-r.resultCh
+		r.result = &res
+	}
+}
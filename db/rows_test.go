@@ -0,0 +1,65 @@
+package db
+
+import (
+	"strconv"
+	"testing"
+)
+
+func TestExecuteRows(t *testing.T) {
+	db := mustCreateDB(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, name TEXT)")
+	for i := 1; i <= 3; i += 1 {
+		mustExecute(t, db, "INSERT INTO foo (name) VALUES ('n"+strconv.Itoa(i)+"')")
+	}
+
+	t.Run("streams each row", func(t *testing.T) {
+		statements := db.Tokenize("SELECT * FROM foo")
+		rows := db.ExecuteRows(statements[0], []any{})
+		header := rows.Header()
+		if len(header) != 2 || header[0] != "id" || header[1] != "name" {
+			t.Fatalf("expected header [id name] got %v", header)
+		}
+		gotRows := 0
+		for row, ok := rows.Next(); ok; row, ok = rows.Next() {
+			gotRows += 1
+			if id := *row[0]; id != strconv.Itoa(gotRows) {
+				t.Fatalf("expected id %d got %s", gotRows, id)
+			}
+			if name := *row[1]; name != "n"+strconv.Itoa(gotRows) {
+				t.Fatalf("expected name n%d got %s", gotRows, name)
+			}
+		}
+		if gotRows != 3 {
+			t.Fatalf("expected 3 rows got %d", gotRows)
+		}
+		if err := rows.Err(); err != nil {
+			t.Fatalf("expected no err got %s", err)
+		}
+	})
+
+	t.Run("close releases the transaction", func(t *testing.T) {
+		statements := db.Tokenize("SELECT * FROM foo")
+		rows := db.ExecuteRows(statements[0], []any{})
+		if _, ok := rows.Next(); !ok {
+			t.Fatal("expected a first row")
+		}
+		rows.Close()
+		if err := rows.Err(); err != nil {
+			t.Fatalf("expected no err after close got %s", err)
+		}
+		// A write after the early close proves the read transaction was
+		// released.
+		mustExecute(t, db, "INSERT INTO foo (name) VALUES ('n4')")
+	})
+
+	t.Run("errors surface once exhausted", func(t *testing.T) {
+		statements := db.Tokenize("SELECT * FROM bar")
+		rows := db.ExecuteRows(statements[0], []any{})
+		if _, ok := rows.Next(); ok {
+			t.Fatal("expected no rows")
+		}
+		if err := rows.Err(); err == nil {
+			t.Fatal("expected err for missing table")
+		}
+	})
+}
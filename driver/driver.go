@@ -2,7 +2,6 @@
 package driver
 
 // TODO there are several context methods that are not implemented.
-// TODO transactions statements are not supported.
 
 import (
 	"database/sql"
@@ -46,7 +45,31 @@ type cdbConn struct {
 
 // Begin implements driver.Conn.
 func (c *cdbConn) Begin() (driver.Tx, error) {
-	panic("Transactions not implemented")
+	if err := c.exec("BEGIN"); err != nil {
+		return nil, err
+	}
+	return &cdbTx{conn: c}, nil
+}
+
+// exec executes the sql without parameters and returns the execution error.
+func (c *cdbConn) exec(sql string) error {
+	statements := c.cdb.Tokenize(sql)
+	result := c.cdb.Execute(statements[0], []any{})
+	return result.Err
+}
+
+type cdbTx struct {
+	conn *cdbConn
+}
+
+// Commit implements driver.Tx.
+func (t *cdbTx) Commit() error {
+	return t.conn.exec("COMMIT")
+}
+
+// Rollback implements driver.Tx.
+func (t *cdbTx) Rollback() error {
+	return t.conn.exec("ROLLBACK")
 }
 
 // Close implements driver.Conn.
@@ -97,15 +120,22 @@ func (c *cdbStmt) NumInput() int {
 	return -1
 }
 
-// Query implements driver.Stmt.
+// Query implements driver.Stmt. The result rows stream from the executing
+// statement as Next is called so memory stays bounded by one row. One row is
+// read ahead so errors raised before the first row are returned here like they
+// were when the result was materialized.
 func (c *cdbStmt) Query(args []driver.Value) (driver.Rows, error) {
-	result := c.cdb.Execute(c.statement, toAny(args))
-	if result.Err != nil {
-		return nil, result.Err
+	rows := c.cdb.ExecuteRows(c.statement, toAny(args))
+	pending, hasPending := rows.Next()
+	if !hasPending {
+		if err := rows.Err(); err != nil {
+			return nil, err
+		}
 	}
 	cr := &cdbRows{
-		cols: result.ResultHeader,
-		rows: result.ResultRows,
+		rows:       rows,
+		pending:    pending,
+		hasPending: hasPending,
 	}
 	return cr, nil
 }
@@ -131,31 +161,45 @@ func (c *cdbResult) RowsAffected() (int64, error) {
 }
 
 type cdbRows struct {
-	cols   []string
-	rows   [][]*string
-	rowIdx int
+	rows *db.Rows
+	// pending holds the row Query read ahead to surface fast failures.
+	pending []*string
+	// hasPending is true when pending holds a row.
+	hasPending bool
 }
 
-// Close implements driver.Rows.
+// Close implements driver.Rows. Closing releases the transaction held by the
+// executing statement.
 func (c *cdbRows) Close() error {
+	c.rows.Close()
 	return nil
 }
 
 // Columns implements driver.Rows.
 func (c *cdbRows) Columns() []string {
-	return c.cols
+	return c.rows.Header()
 }
 
 // Next implements driver.Rows.
 func (c *cdbRows) Next(dest []driver.Value) error {
-	if c.rowIdx == len(c.rows) {
-		return io.EOF
+	row := c.pending
+	if c.hasPending {
+		c.pending = nil
+		c.hasPending = false
+	} else {
+		var ok bool
+		row, ok = c.rows.Next()
+		if !ok {
+			if err := c.rows.Err(); err != nil {
+				return err
+			}
+			return io.EOF
+		}
 	}
-	for i, v := range c.rows[c.rowIdx] {
+	for i, v := range row {
 		// TODO the value is a string pointer, but might be better as a typed
 		// value. It is a string pointer so it can be null.
 		dest[i] = *v
 	}
-	c.rowIdx += 1
 	return nil
 }
@@ -167,3 +167,42 @@ func TestInsertWithParams(t *testing.T) {
 		})
 	}
 }
+
+func TestTransaction(t *testing.T) {
+	db := mustOpenSqlDb(t)
+	mustExecute(t, db, "CREATE TABLE foo (id INTEGER PRIMARY KEY, name TEXT)")
+
+	tx, err := db.Begin()
+	if err != nil {
+		t.Fatalf("begin err %s", err)
+	}
+	if _, err := tx.Exec("INSERT INTO foo (name) VALUES ('one')"); err != nil {
+		t.Fatalf("exec err %s", err)
+	}
+	if err := tx.Commit(); err != nil {
+		t.Fatalf("commit err %s", err)
+	}
+
+	tx, err = db.Begin()
+	if err != nil {
+		t.Fatalf("begin err %s", err)
+	}
+	if _, err := tx.Exec("INSERT INTO foo (name) VALUES ('two')"); err != nil {
+		t.Fatalf("exec err %s", err)
+	}
+	if err := tx.Rollback(); err != nil {
+		t.Fatalf("rollback err %s", err)
+	}
+
+	rows, err := db.Query("SELECT * FROM foo")
+	if err != nil {
+		t.Fatalf("query err %s", err)
+	}
+	fs := toFoos(rows)
+	if d := len(fs); d != 1 {
+		t.Fatalf("expected 1 got %d", d)
+	}
+	if fs[0].name != "one" {
+		t.Fatalf("expected one got %s", fs[0].name)
+	}
+}
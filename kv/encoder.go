@@ -2,11 +2,186 @@ package kv
 
 import (
 	"bytes"
+	"encoding/binary"
 	"encoding/gob"
 	"fmt"
+	"math"
 )
 
+// Record values are encoded with a compact serial type format. A record is a
+// header followed by the packed column values. The header is a varint count of
+// columns followed by a varint serial type per column. The serial type both
+// identifies the column type and sizes the value meaning no type metadata is
+// stored per record beyond a handful of bytes.
+//
+// Files created before this format existed store gob encoded records. The
+// record format byte in the pager's file header selects which format a
+// database uses so existing files keep working.
+const (
+	// serialTypeNull is a null value taking no space in the record body.
+	serialTypeNull = 0
+	// serialTypeInt8 is an integer stored as 1 byte.
+	serialTypeInt8 = 1
+	// serialTypeInt16 is an integer stored as 2 bytes.
+	serialTypeInt16 = 2
+	// serialTypeInt32 is an integer stored as 4 bytes.
+	serialTypeInt32 = 3
+	// serialTypeInt64 is an integer stored as 8 bytes.
+	serialTypeInt64 = 4
+	// serialTypeBlobBase is the base for blob serial types. A blob of n bytes
+	// has the serial type 2n+12 meaning blob serial types are even.
+	serialTypeBlobBase = 12
+	// serialTypeStringBase is the base for string serial types. A string of n
+	// bytes has the serial type 2n+13 meaning string serial types are odd.
+	serialTypeStringBase = 13
+)
+
+// Encode encodes the record values with the serial type format.
 func Encode(v []interface{}) ([]byte, error) {
+	header := binary.AppendUvarint([]byte{}, uint64(len(v)))
+	body := []byte{}
+	for _, col := range v {
+		switch t := col.(type) {
+		case nil:
+			header = binary.AppendUvarint(header, serialTypeNull)
+		case int:
+			switch {
+			case math.MinInt8 <= t && t <= math.MaxInt8:
+				header = binary.AppendUvarint(header, serialTypeInt8)
+				body = append(body, byte(int8(t)))
+			case math.MinInt16 <= t && t <= math.MaxInt16:
+				header = binary.AppendUvarint(header, serialTypeInt16)
+				body = binary.LittleEndian.AppendUint16(body, uint16(int16(t)))
+			case math.MinInt32 <= t && t <= math.MaxInt32:
+				header = binary.AppendUvarint(header, serialTypeInt32)
+				body = binary.LittleEndian.AppendUint32(body, uint32(int32(t)))
+			default:
+				header = binary.AppendUvarint(header, serialTypeInt64)
+				body = binary.LittleEndian.AppendUint64(body, uint64(t))
+			}
+		case string:
+			header = binary.AppendUvarint(header, uint64(2*len(t)+serialTypeStringBase))
+			body = append(body, t...)
+		case []byte:
+			header = binary.AppendUvarint(header, uint64(2*len(t)+serialTypeBlobBase))
+			body = append(body, t...)
+		default:
+			return nil, fmt.Errorf("err encoding value of unsupported type %T", col)
+		}
+	}
+	return append(header, body...), nil
+}
+
+// Decode decodes a record encoded with the serial type format.
+func Decode(v []byte) ([]any, error) {
+	buf := bytes.NewBuffer(v)
+	count, err := binary.ReadUvarint(buf)
+	if err != nil {
+		return nil, fmt.Errorf("err decoding value header %w", err)
+	}
+	serialTypes := make([]uint64, count)
+	for i := uint64(0); i < count; i += 1 {
+		st, err := binary.ReadUvarint(buf)
+		if err != nil {
+			return nil, fmt.Errorf("err decoding value header %w", err)
+		}
+		serialTypes[i] = st
+	}
+	body := buf.Bytes()
+	s := make([]any, count)
+	offset := 0
+	for i, st := range serialTypes {
+		sv, err := decodeSerialValue(st, body[offset:])
+		if err != nil {
+			return nil, err
+		}
+		s[i] = sv
+		offset += serialTypeSize(st)
+	}
+	return s, nil
+}
+
+// DecodeColumn decodes the single column at the given index from a record
+// encoded with the serial type format. Only the record header and the
+// requested value are read meaning the cost does not depend on the count or
+// width of the other columns in the record.
+func DecodeColumn(v []byte, column int) (any, error) {
+	buf := bytes.NewBuffer(v)
+	count, err := binary.ReadUvarint(buf)
+	if err != nil {
+		return nil, fmt.Errorf("err decoding value header %w", err)
+	}
+	if uint64(column) >= count {
+		return nil, fmt.Errorf("err decoding column %d of %d column record", column, count)
+	}
+	// The value's offset in the body is the sum of the sizes of the values
+	// before it which are derivable from the header alone. The header must be
+	// read fully since the body begins where the header ends.
+	target := uint64(0)
+	offset := 0
+	for i := uint64(0); i < count; i += 1 {
+		st, err := binary.ReadUvarint(buf)
+		if err != nil {
+			return nil, fmt.Errorf("err decoding value header %w", err)
+		}
+		if i < uint64(column) {
+			offset += serialTypeSize(st)
+		}
+		if i == uint64(column) {
+			target = st
+		}
+	}
+	return decodeSerialValue(target, buf.Bytes()[offset:])
+}
+
+// serialTypeSize returns the count of bytes the serial type takes in the
+// record body.
+func serialTypeSize(st uint64) int {
+	switch st {
+	case serialTypeNull:
+		return 0
+	case serialTypeInt8:
+		return 1
+	case serialTypeInt16:
+		return 2
+	case serialTypeInt32:
+		return 4
+	case serialTypeInt64:
+		return 8
+	}
+	if st%2 == 0 {
+		return int(st-serialTypeBlobBase) / 2
+	}
+	return int(st-serialTypeStringBase) / 2
+}
+
+// decodeSerialValue decodes a single value of the serial type from the start
+// of the body bytes.
+func decodeSerialValue(st uint64, body []byte) (any, error) {
+	switch {
+	case st == serialTypeNull:
+		return nil, nil
+	case st == serialTypeInt8:
+		return int(int8(body[0])), nil
+	case st == serialTypeInt16:
+		return int(int16(binary.LittleEndian.Uint16(body))), nil
+	case st == serialTypeInt32:
+		return int(int32(binary.LittleEndian.Uint32(body))), nil
+	case st == serialTypeInt64:
+		return int(binary.LittleEndian.Uint64(body)), nil
+	case st >= serialTypeBlobBase && st%2 == 0:
+		n := int(st-serialTypeBlobBase) / 2
+		return append([]byte{}, body[:n]...), nil
+	case st >= serialTypeStringBase:
+		n := int(st-serialTypeStringBase) / 2
+		return string(body[:n]), nil
+	}
+	return nil, fmt.Errorf("err decoding value of serial type %d", st)
+}
+
+// encodeGob encodes a record with encoding/gob for files created before the
+// serial type format existed.
+func encodeGob(v []interface{}) ([]byte, error) {
 	var buf bytes.Buffer
 	err := gob.NewEncoder(&buf).Encode(&v)
 	if err != nil {
@@ -15,7 +190,9 @@ func Encode(v []interface{}) ([]byte, error) {
 	return buf.Bytes(), nil
 }
 
-func Decode(v []byte) ([]any, error) {
+// decodeGob decodes a gob encoded record for files created before the serial
+// type format existed.
+func decodeGob(v []byte) ([]any, error) {
 	buf := bytes.NewBuffer(v)
 	var s []any
 	err := gob.NewDecoder(buf).Decode(&s)
@@ -23,6 +23,90 @@ func TestEncoding(t *testing.T) {
 		}
 	})
 
+	t.Run("encode/decode serial types", func(t *testing.T) {
+		cases := [][]any{
+			{nil},
+			{1},
+			{-1},
+			{1000},
+			{-1000},
+			{100_000},
+			{10_000_000_000},
+			{-10_000_000_000},
+			{""},
+			{"gregory"},
+			{[]byte{1, 2, 3}},
+			{nil, 42, "mixed", nil},
+		}
+		for _, c := range cases {
+			e, err := Encode(c)
+			if err != nil {
+				t.Fatal(err)
+			}
+			d, err := Decode(e)
+			if err != nil {
+				t.Fatal(err)
+			}
+			if !reflect.DeepEqual(c, d) {
+				t.Fatalf("want %#v got %#v", c, d)
+			}
+		}
+	})
+
+	t.Run("decode single column", func(t *testing.T) {
+		v := []any{nil, 42, "gregory", []byte{7}, -100_000}
+		e, err := Encode(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		for i := range v {
+			d, err := DecodeColumn(e, i)
+			if err != nil {
+				t.Fatal(err)
+			}
+			if !reflect.DeepEqual(v[i], d) {
+				t.Fatalf("want %#v got %#v", v[i], d)
+			}
+		}
+		if _, err := DecodeColumn(e, len(v)); err == nil {
+			t.Fatal("expected err for column out of range")
+		}
+	})
+
+	t.Run("encode is compact", func(t *testing.T) {
+		v := []any{1, "gregory"}
+		e, err := Encode(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		// count + 2 serial types + 1 int byte + 7 string bytes
+		if want := 11; len(e) != want {
+			t.Fatalf("want %d bytes got %d", want, len(e))
+		}
+		g, err := encodeGob(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if len(g) <= len(e) {
+			t.Fatalf("want gob %d to be larger than serial %d", len(g), len(e))
+		}
+	})
+
+	t.Run("encode/decode gob", func(t *testing.T) {
+		v := []any{2, "carl"}
+		e, err := encodeGob(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		d, err := decodeGob(e)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if !reflect.DeepEqual(v, d) {
+			t.Fatalf("want %#v got %#v", v, d)
+		}
+	})
+
 	t.Run("encode/decode key", func(t *testing.T) {
 		v := 1
 		vb, err := EncodeKey(v)
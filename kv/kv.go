@@ -9,7 +9,9 @@ import (
 	"encoding/binary"
 	"fmt"
 	"log"
+	"runtime"
 	"slices"
+	"sync"
 
 	"github.com/chirst/cdb/catalog"
 	"github.com/chirst/cdb/pager"
@@ -20,6 +22,20 @@ import (
 type KV struct {
 	pager   *pager.Pager
 	catalog *catalog.Catalog
+	// maxRowIDMu guards maxRowIDs and maxRowIDVersion.
+	maxRowIDMu sync.Mutex
+	// maxRowIDs caches the largest assigned rowid per root page number so
+	// generating a new rowid is a counter bump instead of a descent to the
+	// rightmost leaf. The cache is filled lazily and dropped on rollback.
+	maxRowIDs map[int]int
+	// recordFormat is the record format version of the database file. Files
+	// created before the serial type record format store gob encoded records.
+	recordFormat int
+	// maxRowIDVersion is the file change counter the rowid cache was built
+	// against. A counter observed at the start of a write transaction that
+	// does not match means another process has changed the file and the cache
+	// must be dropped.
+	maxRowIDVersion int
 }
 
 // New creates an instance of kv
@@ -30,8 +46,10 @@ func New(useMemory bool, filename string) (*KV, error) {
 	}
 	catalog := catalog.NewCatalog()
 	ret := &KV{
-		pager:   pager,
-		catalog: catalog,
+		pager:        pager,
+		catalog:      catalog,
+		maxRowIDs:    map[int]int{},
+		recordFormat: pager.RecordFormat(),
 	}
 	err = ret.ParseSchema()
 	if err != nil {
@@ -45,6 +63,12 @@ func (kv *KV) GetCatalog() *catalog.Catalog {
 	return kv.catalog
 }
 
+// PageCacheStats returns the count of page cache hits and misses since the
+// pager was created.
+func (kv *KV) PageCacheStats() (hits, misses int) {
+	return kv.pager.CacheStats()
+}
+
 // NewBTree creates an empty BTree and returns the new tree's root page number.
 func (kv *KV) NewBTree() int {
 	np := kv.pager.NewPage()
@@ -63,17 +87,70 @@ func (kv *KV) EndReadTransaction() {
 
 // BeginWriteTransaction begins a write transaction.
 func (kv *KV) BeginWriteTransaction() error {
-	return kv.pager.BeginWrite()
+	if err := kv.pager.BeginWrite(); err != nil {
+		return err
+	}
+	kv.maxRowIDMu.Lock()
+	defer kv.maxRowIDMu.Unlock()
+	if v := kv.pager.FileChangeCounter(); v != kv.maxRowIDVersion {
+		kv.maxRowIDs = map[int]int{}
+		kv.maxRowIDVersion = v
+	}
+	return nil
 }
 
 // RollbackWrite rolls back and ends a write transaction.
 func (kv *KV) RollbackWrite() {
+	kv.maxRowIDMu.Lock()
+	kv.maxRowIDs = map[int]int{}
+	kv.maxRowIDMu.Unlock()
 	kv.pager.RollbackWrite()
 }
 
 // EndWriteTransaction ends a write transaction.
 func (kv *KV) EndWriteTransaction() error {
-	return kv.pager.EndWrite()
+	if err := kv.pager.EndWrite(); err != nil {
+		return err
+	}
+	// The commit bumped the file change counter. Recording the new counter
+	// keeps the rowid cache warm across this process's own transactions while
+	// still dropping it when another process commits.
+	kv.maxRowIDMu.Lock()
+	kv.maxRowIDVersion = kv.pager.FileChangeCounter()
+	kv.maxRowIDMu.Unlock()
+	return nil
+}
+
+// Encode encodes the record values with the record format of the database
+// file.
+func (kv *KV) Encode(v []any) ([]byte, error) {
+	if kv.recordFormat == pager.RecordFormatGob {
+		return encodeGob(v)
+	}
+	return Encode(v)
+}
+
+// Decode decodes a record with the record format of the database file.
+func (kv *KV) Decode(v []byte) ([]any, error) {
+	if kv.recordFormat == pager.RecordFormatGob {
+		return decodeGob(v)
+	}
+	return Decode(v)
+}
+
+// DecodeColumn decodes the single column at the given index from a record
+// with the record format of the database file. For the serial type format
+// only the requested column is decoded. The gob format has no random access
+// so the whole record is decoded.
+func (kv *KV) DecodeColumn(v []byte, column int) (any, error) {
+	if kv.recordFormat == pager.RecordFormatGob {
+		cols, err := decodeGob(v)
+		if err != nil {
+			return nil, err
+		}
+		return cols[column], nil
+	}
+	return DecodeColumn(v, column)
 }
 
 // ParseSchema updates the system catalog by reading the schema table.
@@ -86,7 +163,7 @@ func (kv *KV) ParseSchema() error {
 	var objects []catalog.Object
 	for exists {
 		v := c.GetValue()
-		dv, err := Decode(v)
+		dv, err := kv.Decode(v)
 		if err != nil {
 			return err
 		}
@@ -104,6 +181,195 @@ func (kv *KV) ParseSchema() error {
 	return nil
 }
 
+// Vacuum compacts the database file by rewriting every B tree with the bulk
+// load path. Page allocation restarts from the front of the file so the
+// rebuilt trees are packed densely and the file is truncated to the last
+// allocated page when the transaction commits. Root page numbers change so the
+// schema table is rewritten with the new roots and the caller must reparse the
+// schema. Vacuum must be called during a write transaction.
+func (kv *KV) Vacuum() error {
+	// Every tree is read into memory before allocation restarts since the
+	// rebuilt trees reuse the pages being read. Overflow chains are resolved
+	// so the values are rechunked into fresh chains when they are rewritten.
+	type row struct {
+		key   []byte
+		value []byte
+	}
+	copyTree := func(root int) ([]row, error) {
+		rows := []row{}
+		c := kv.NewCursor(root)
+		for exists := c.GotoFirstRecord(); exists; exists = c.GotoNext() {
+			rows = append(rows, row{
+				key:   append([]byte{}, c.GetKey()...),
+				value: append([]byte{}, c.GetValue()...),
+			})
+		}
+		return rows, nil
+	}
+	schemaRows, err := copyTree(1)
+	if err != nil {
+		return err
+	}
+	records := make([][]any, len(schemaRows))
+	trees := make([][]row, len(schemaRows))
+	for i := range schemaRows {
+		records[i], err = kv.Decode(schemaRows[i].value)
+		if err != nil {
+			return err
+		}
+		// Only table objects own a tree. Other objects like stats have no
+		// root page and carry through the schema rewrite unchanged.
+		if records[i][0].(string) != "table" {
+			continue
+		}
+		trees[i], err = copyTree(records[i][3].(int))
+		if err != nil {
+			return err
+		}
+	}
+	kv.pager.Compact()
+	for i := range trees {
+		if records[i][0].(string) != "table" {
+			continue
+		}
+		root := kv.NewBTree()
+		c := kv.NewCursor(root)
+		for _, r := range trees[i] {
+			if err := c.BulkSet(r.key, r.value); err != nil {
+				return err
+			}
+		}
+		records[i][3] = root
+	}
+	// The schema table is rebuilt in place since its root page number is
+	// reserved.
+	rootPage := kv.pager.GetPage(1)
+	rootPage.SetTypeLeaf()
+	rootPage.SetParentPageNumber(0)
+	rootPage.SetLeftPageNumber(0)
+	rootPage.SetRightPageNumber(0)
+	rootPage.SetEntries([]pager.PageTuple{})
+	c := kv.NewCursor(1)
+	for i := range schemaRows {
+		v, err := kv.Encode(records[i])
+		if err != nil {
+			return err
+		}
+		if err := c.BulkSet(schemaRows[i].key, v); err != nil {
+			return err
+		}
+	}
+	// The rowid cache is keyed by root page number which the vacuum reassigns.
+	kv.maxRowIDMu.Lock()
+	kv.maxRowIDs = map[int]int{}
+	kv.maxRowIDMu.Unlock()
+	return nil
+}
+
+// Analyze gathers statistics for every table and persists them in the schema
+// table as stat objects. A stat row holds the row count, leaf page count, and
+// row id range of its table so the planner can estimate the cost of candidate
+// access paths. Analyzing a table again updates its stat row in place. Analyze
+// must be called during a write transaction and the caller must reparse the
+// schema.
+func (kv *KV) Analyze() error {
+	type schemaRow struct {
+		key    []byte
+		record []any
+	}
+	rows := []schemaRow{}
+	maxSchemaRowID := 0
+	c := kv.NewCursor(1)
+	for exists := c.GotoFirstRecord(); exists; exists = c.GotoNext() {
+		record, err := kv.Decode(c.GetValue())
+		if err != nil {
+			return err
+		}
+		key := append([]byte{}, c.GetKey()...)
+		dk, err := DecodeKey(key)
+		if err != nil {
+			return err
+		}
+		if rid, ok := dk.(int); ok && rid > maxSchemaRowID {
+			maxSchemaRowID = rid
+		}
+		rows = append(rows, schemaRow{key: key, record: record})
+	}
+	// A table analyzed before has its stat row rewritten under the same key.
+	statKeys := map[string][]byte{}
+	for _, r := range rows {
+		if r.record[0].(string) == "stat" {
+			statKeys[r.record[2].(string)] = r.key
+		}
+	}
+	sc := kv.NewCursor(1)
+	for _, r := range rows {
+		if r.record[0].(string) != "table" {
+			continue
+		}
+		tableName := r.record[2].(string)
+		stats, err := kv.analyzeTree(r.record[3].(int))
+		if err != nil {
+			return err
+		}
+		j, err := stats.ToJSON()
+		if err != nil {
+			return err
+		}
+		v, err := kv.Encode([]any{"stat", tableName, tableName, 0, string(j)})
+		if err != nil {
+			return err
+		}
+		key, analyzed := statKeys[tableName]
+		if !analyzed {
+			maxSchemaRowID += 1
+			key, err = EncodeKey(maxSchemaRowID)
+			if err != nil {
+				return err
+			}
+		}
+		if err := sc.Set(key, v); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// analyzeTree walks the leaf chain of the tree gathering statistics. The walk
+// reads page counters and boundary keys meaning no record values are decoded.
+func (kv *KV) analyzeTree(rootPageNumber int) (*catalog.TableStats, error) {
+	stats := &catalog.TableStats{}
+	c := kv.NewCursor(rootPageNumber)
+	if !c.GotoFirstRecord() {
+		return stats, nil
+	}
+	if mk, err := DecodeKey(c.GetKey()); err == nil {
+		if rid, ok := mk.(int); ok {
+			stats.MinRowID = rid
+		}
+	}
+	var lastKey []byte
+	for {
+		recordCount := c.currentPage.GetRecordCount()
+		stats.LeafPages += 1
+		stats.RowCount += recordCount
+		if recordCount != 0 {
+			lastKey = slices.Clone(c.currentPage.GetTuple(recordCount - 1).Key)
+		}
+		if !c.gotoNextPage() {
+			break
+		}
+	}
+	if lastKey != nil {
+		if mk, err := DecodeKey(lastKey); err == nil {
+			if rid, ok := mk.(int); ok {
+				stats.MaxRowID = rid
+			}
+		}
+	}
+	return stats, nil
+}
+
 // nextBehavior is the state of GotoNext in relation to DeleteCurrent
 type nextBehavior int
 
@@ -122,12 +388,27 @@ type Cursor struct {
 	rootPageNumber int
 	// currentTupleKey is the current tuple being pointed to
 	currentTupleKey []byte
+	// currentTupleIndex is the slot index of the current tuple on the current
+	// page. The index makes advancing the cursor O(1). The index is
+	// revalidated against the currentTupleKey before it is used since the page
+	// may have been rewritten under the cursor.
+	currentTupleIndex int
 	// currentPage is the current page the cursor is pointing to
 	currentPage *pager.Page
 	// pager is the cursors pager
 	pager *pager.Pager
+	// kv is the owning kv instance which holds the max rowid cache
+	kv *KV
 	// nextBehavior is the state of GotoNext behavior for the cursor
 	nextBehavior nextBehavior
+	// snapshot is true when the cursor belongs to a snapshot read transaction
+	// meaning the cursor must never observe the dirty pages of an in flight
+	// write transaction.
+	snapshot bool
+	// bulkLeafPageNumber caches the rightmost leaf page between BulkSet calls
+	// so sorted loads skip the root to leaf descent. 0 means no page is
+	// cached.
+	bulkLeafPageNumber int
 }
 
 // NewCursor creates a cursor with the given object's rootPageNumber.
@@ -138,33 +419,60 @@ func (kv *KV) NewCursor(rootPageNumber int) *Cursor {
 	return &Cursor{
 		rootPageNumber: rootPageNumber,
 		pager:          kv.pager,
+		kv:             kv,
 	}
 }
 
+// NewSnapshotCursor creates a cursor for a read transaction. The cursor reads
+// the pre commit page versions while a writer in the same process prepares its
+// dirty page set.
+func (kv *KV) NewSnapshotCursor(rootPageNumber int) *Cursor {
+	c := kv.NewCursor(rootPageNumber)
+	c.snapshot = true
+	return c
+}
+
+// getPage reads a page with the snapshot visibility of the cursor.
+func (c *Cursor) getPage(pageNumber int) *pager.Page {
+	if c.snapshot {
+		return c.pager.GetSnapshotPage(pageNumber)
+	}
+	return c.pager.GetPage(pageNumber)
+}
+
 // getCurrentEntriesIndex gets the index of the currentKey within the pages
-// current entries. Note a special value of -1 is returned in the rare case
-// the current key doesn't exist.
+// current entries. The tracked currentTupleIndex is returned when it still
+// points at the current key. Otherwise the page has changed under the cursor
+// and the index is recovered with a binary search re-seek. Note a special
+// value of -1 is returned in the rare case the current key doesn't exist.
 func (c *Cursor) getCurrentEntriesIndex() int {
-	return slices.IndexFunc(
-		c.currentPage.GetEntries(),
-		func(t pager.PageTuple) bool {
-			return bytes.Equal(t.Key, c.currentTupleKey)
-		},
-	)
+	if c.currentTupleIndex < c.currentPage.GetRecordCount() &&
+		bytes.Equal(c.currentPage.GetTuple(c.currentTupleIndex).Key, c.currentTupleKey) {
+		return c.currentTupleIndex
+	}
+	i, exactMatch := c.currentPage.FindTupleIndex(c.currentTupleKey)
+	if !exactMatch {
+		return -1
+	}
+	return i
 }
 
 // GotoFirstRecord moves the cursor to the first tuple in ascending order. It
 // returns true if the table has values. It returns false if the table is empty.
 func (c *Cursor) GotoFirstRecord() bool {
-	candidatePage := c.pager.GetPage(c.rootPageNumber)
-	if len(candidatePage.GetEntries()) == 0 {
+	candidatePage := c.getPage(c.rootPageNumber)
+	if candidatePage.GetRecordCount() == 0 {
 		return false
 	}
 	for !candidatePage.IsLeaf() {
-		pagePointers := candidatePage.GetEntries()
-		ascendingPageNum := pagePointers[0].Value
+		ascendingPageNum := candidatePage.GetTuple(0).Value
 		ascendingPageNum32 := binary.LittleEndian.Uint32(ascendingPageNum)
-		candidatePage = c.pager.GetPage(int(ascendingPageNum32))
+		candidatePage = c.getPage(int(ascendingPageNum32))
+	}
+	// A cursor starting at the first leaf is likely scanning the leaf chain so
+	// hint the pager to read the chain ahead of the cursor.
+	if hasRight, rightPageNumber := candidatePage.GetRightPageNumber(); hasRight {
+		c.pager.PrefetchScan(rightPageNumber)
 	}
 	c.moveToPage(candidatePage)
 	return true
@@ -174,41 +482,63 @@ func (c *Cursor) GotoFirstRecord() bool {
 // (descending ordering). It returns true if the table has values otherwise
 // false.
 func (c *Cursor) GotoLastRecord() bool {
-	candidatePage := c.pager.GetPage(c.rootPageNumber)
-	if len(candidatePage.GetEntries()) == 0 {
+	candidatePage := c.getPage(c.rootPageNumber)
+	if candidatePage.GetRecordCount() == 0 {
 		return false
 	}
 	for !candidatePage.IsLeaf() {
-		pagePointers := candidatePage.GetEntries()
-		descendingPageNum := pagePointers[len(pagePointers)-1].Value
+		descendingPageNum := candidatePage.GetTuple(candidatePage.GetRecordCount() - 1).Value
 		descendingPageNum32 := binary.LittleEndian.Uint32(descendingPageNum)
-		candidatePage = c.pager.GetPage(int(descendingPageNum32))
+		candidatePage = c.getPage(int(descendingPageNum32))
 	}
 	c.moveToPage(candidatePage)
-	entries := c.currentPage.GetEntries()
-	c.currentTupleKey = entries[len(entries)-1].Key
+	c.moveToIndex(c.currentPage.GetRecordCount() - 1)
 	return true
 }
 
 func (c *Cursor) GotoKey(key []byte) bool {
-	candidatePage := c.pager.GetPage(c.rootPageNumber)
+	candidatePage := c.getPage(c.rootPageNumber)
 	for !candidatePage.IsLeaf() {
 		v, exists := candidatePage.GetValue(key)
 		if !exists {
 			return false
 		}
 		nextPageNumber := int(binary.LittleEndian.Uint32(v))
-		candidatePage = c.pager.GetPage(nextPageNumber)
+		candidatePage = c.getPage(nextPageNumber)
 	}
 	c.moveToPage(candidatePage)
-	entries := c.currentPage.GetEntries()
-	for i, e := range entries {
-		if bytes.Equal(e.Key, key) {
-			c.currentTupleKey = entries[i].Key
-			return true
+	i, exactMatch := c.currentPage.FindTupleIndex(key)
+	if !exactMatch {
+		return false
+	}
+	c.moveToIndex(i)
+	return true
+}
+
+// GotoKeyGt moves the cursor to the first tuple whose key is greater than the
+// given key. The key does not have to exist in the tree. It returns true when
+// such a tuple exists otherwise false. This supports range scans that seek to
+// a lower bound instead of scanning from the first tuple.
+func (c *Cursor) GotoKeyGt(key []byte) bool {
+	candidatePage := c.getLeafPage(c.rootPageNumber, key)
+	if candidatePage == nil {
+		return false
+	}
+	i, exactMatch := candidatePage.FindTupleIndex(key)
+	if exactMatch {
+		i += 1
+	}
+	for i >= candidatePage.GetRecordCount() {
+		hasRight, rightPageNumber := candidatePage.GetRightPageNumber()
+		if !hasRight {
+			return false
 		}
+		candidatePage = c.getPage(rightPageNumber)
+		i = 0
 	}
-	return false
+	c.moveToPage(candidatePage)
+	c.moveToIndex(i)
+	return true
 }
 
 // GetKey returns the key of the current tuple.
@@ -219,7 +549,7 @@ func (c *Cursor) GetKey() []byte {
 // GetValue returns the value of the current pointed to tuple
 func (c *Cursor) GetValue() []byte {
 	v, _ := c.currentPage.GetValue(c.currentTupleKey)
-	return v
+	return c.resolveValue(v)
 }
 
 // DeleteCurrent deletes the current tuple the cursor is pointing to. This
@@ -227,7 +557,12 @@ func (c *Cursor) GetValue() []byte {
 // will be a no-op. If the next tuple is the end of the table GotoNext will also
 // be aware of this. This is all to facilitate execution plans which delete in a
 // loop.
-func (c *Cursor) DeleteCurrent() {
+func (c *Cursor) DeleteCurrent() error {
+	c.deleteCurrent()
+	return c.spill()
+}
+
+func (c *Cursor) deleteCurrent() {
 	newEntries := []pager.PageTuple{}
 	var nextKey []byte
 	foundNextKey := false
@@ -237,6 +572,9 @@ func (c *Cursor) DeleteCurrent() {
 		comparison := bytes.Compare(e.Key, c.currentTupleKey)
 		if comparison != 0 { // a != b
 			newEntries = append(newEntries, e)
+		} else {
+			// The deleted value may own an overflow chain.
+			c.freeOverflow(e.Value)
 		}
 		if comparison == 1 && !foundNextKey { // a > b
 			foundNextKey = true
@@ -244,14 +582,14 @@ func (c *Cursor) DeleteCurrent() {
 		}
 	}
 	// Set the current page entries minus the deleted entry.
-	newPage := c.pager.GetPage(c.currentPage.GetNumber())
+	newPage := c.getPage(c.currentPage.GetNumber())
 	newPage.SetEntries(newEntries)
 	// Determine what the next key is and setup flag for GotoNext.
 	if !foundNextKey {
 		hasRight, rightPageNumber := c.currentPage.GetRightPageNumber()
 		if hasRight {
 			c.nextBehavior = nextBehaviorNext
-			c.moveToPage(c.pager.GetPage(rightPageNumber))
+			c.moveToPage(c.getPage(rightPageNumber))
 		} else {
 			c.nextBehavior = nextBehaviorEmpty
 		}
@@ -259,6 +597,152 @@ func (c *Cursor) DeleteCurrent() {
 		c.nextBehavior = nextBehaviorNext
 		c.currentTupleKey = nextKey
 	}
+	c.rebalance(newPage)
+}
+
+// rebalance restores the tree after a delete has shrunk the page. An emptied
+// page is unlinked from the tree. An underfull page is merged with a sibling
+// sharing its parent when the combined entries fit in one page. Removing a
+// page removes its pointer from the parent meaning the parent may become
+// underfull and rebalance up the tree. A root left with a single child is
+// collapsed so the tree height shrinks.
+func (c *Cursor) rebalance(page *pager.Page) {
+	hasParent, parentPageNumber := page.GetParentPageNumber()
+	if !hasParent {
+		c.collapseRoot(page)
+		return
+	}
+	if page.GetRecordCount() == 0 {
+		c.unlink(page, parentPageNumber)
+		return
+	}
+	if !page.IsUnderfull() {
+		return
+	}
+	c.mergeSiblings(page, parentPageNumber)
+}
+
+// unlink removes the page from the tree by fixing the sibling chain around it,
+// removing its pointers from the parent, and returning it to the free list.
+// The parent is then rebalanced since it may have become underfull.
+func (c *Cursor) unlink(page *pager.Page, parentPageNumber int) {
+	parent := c.getPage(parentPageNumber)
+	pn := page.GetNumberAsBytes()
+	kept := []pager.PageTuple{}
+	for _, e := range parent.GetEntries() {
+		if !bytes.Equal(e.Value, pn) {
+			kept = append(kept, e)
+		}
+	}
+	if len(kept) == parent.GetRecordCount() {
+		// The recorded parent holds no pointer to the page meaning the parent
+		// pointer is stale. The page is left in place since another internal
+		// page may still reference it.
+		return
+	}
+	_, leftPageNumber := page.GetLeftPageNumber()
+	_, rightPageNumber := page.GetRightPageNumber()
+	if leftPageNumber != 0 {
+		c.getPage(leftPageNumber).SetRightPageNumber(rightPageNumber)
+	}
+	if rightPageNumber != 0 {
+		c.getPage(rightPageNumber).SetLeftPageNumber(leftPageNumber)
+	}
+	parent.SetEntries(kept)
+	c.pager.FreePage(page)
+	c.rebalance(parent)
+}
+
+// mergeSiblings merges the underfull page with its left or right sibling when
+// the sibling shares the page's parent and the combined entries fit in one
+// page. The emptied page of the merge is unlinked.
+func (c *Cursor) mergeSiblings(page *pager.Page, parentPageNumber int) {
+	// Nothing is merged unless the parent is known to reference the page being
+	// merged away since unlinking it depends on removing that reference.
+	_, leftPageNumber := page.GetLeftPageNumber()
+	if leftPageNumber != 0 && c.parentHasPointer(parentPageNumber, page) {
+		left := c.getPage(leftPageNumber)
+		_, leftParent := left.GetParentPageNumber()
+		if leftParent == parentPageNumber && left.CanInsertTuples(page.GetEntries()) {
+			left.SetEntries(append(left.GetEntries(), page.GetEntries()...))
+			c.adoptChildren(left)
+			// The cursor may be pointing at the page being merged away.
+			if c.currentPage != nil && c.currentPage.GetNumber() == page.GetNumber() {
+				c.currentPage = left
+			}
+			c.unlink(page, parentPageNumber)
+			return
+		}
+	}
+	_, rightPageNumber := page.GetRightPageNumber()
+	if rightPageNumber != 0 {
+		right := c.getPage(rightPageNumber)
+		_, rightParent := right.GetParentPageNumber()
+		if rightParent == parentPageNumber &&
+			c.parentHasPointer(parentPageNumber, right) &&
+			page.CanInsertTuples(right.GetEntries()) {
+			page.SetEntries(append(page.GetEntries(), right.GetEntries()...))
+			c.adoptChildren(page)
+			if c.currentPage != nil && c.currentPage.GetNumber() == right.GetNumber() {
+				c.currentPage = page
+			}
+			c.unlink(right, parentPageNumber)
+		}
+	}
+}
+
+// parentHasPointer returns true when the parent page holds a pointer entry to
+// the given page.
+func (c *Cursor) parentHasPointer(parentPageNumber int, page *pager.Page) bool {
+	pn := page.GetNumberAsBytes()
+	for _, e := range c.getPage(parentPageNumber).GetEntries() {
+		if bytes.Equal(e.Value, pn) {
+			return true
+		}
+	}
+	return false
+}
+
+// collapseRoot shrinks the height of the tree when deletes leave the root with
+// a single child. The child's entries move into the root since the root page
+// number is reserved by the catalog. An internal root emptied entirely becomes
+// an empty leaf.
+func (c *Cursor) collapseRoot(root *pager.Page) {
+	for !root.IsLeaf() {
+		if root.GetRecordCount() == 0 {
+			root.SetTypeLeaf()
+			return
+		}
+		if root.GetRecordCount() > 1 {
+			return
+		}
+		childPageNumber := int(binary.LittleEndian.Uint32(root.GetTuple(0).Value))
+		child := c.getPage(childPageNumber)
+		if child.IsLeaf() {
+			root.SetTypeLeaf()
+		}
+		root.SetEntries(child.GetEntries())
+		c.adoptChildren(root)
+		if c.currentPage != nil && c.currentPage.GetNumber() == child.GetNumber() {
+			c.currentPage = root
+		}
+		c.pager.FreePage(child)
+	}
+}
+
+// adoptChildren updates the parent pointer of every child the internal page
+// references. Splits and merges move pointer entries between internal pages
+// meaning the referenced children must be re-parented for the parent pointers
+// to stay reliable. Rebalancing depends on this since it navigates to the
+// parent through the pointer.
+func (c *Cursor) adoptChildren(p *pager.Page) {
+	if p.IsLeaf() {
+		return
+	}
+	for _, e := range p.GetEntries() {
+		childPage := c.getPage(int(binary.LittleEndian.Uint32(e.Value)))
+		childPage.SetParentPageNumber(p.GetNumber())
+	}
 }
 
 // GotoNext moves the cursor to the next tuple in ascending order. If there is
@@ -277,13 +761,13 @@ func (c *Cursor) GotoNext() bool {
 		return true
 	case nextBehaviorNormal:
 		currentIndex := c.getCurrentEntriesIndex()
-		if currentIndex+1 <= len(c.currentPage.GetEntries())-1 {
-			c.currentTupleKey = c.currentPage.GetEntries()[currentIndex+1].Key
+		if currentIndex+1 <= c.currentPage.GetRecordCount()-1 {
+			c.moveToIndex(currentIndex + 1)
 			return true
 		}
 		if hasRight, rpn := c.currentPage.GetRightPageNumber(); hasRight {
-			candidatePage := c.pager.GetPage(rpn)
-			if len(candidatePage.GetEntries()) == 0 {
+			candidatePage := c.getPage(rpn)
+			if candidatePage.GetRecordCount() == 0 {
 				return false
 			}
 			c.moveToPage(candidatePage)
@@ -302,39 +786,128 @@ func (c *Cursor) gotoNextPage() bool {
 	if !hasRight {
 		return false
 	}
-	np := c.pager.GetPage(rightPageNumber)
+	// The right pointer makes the pages of the scan predictable so keep the
+	// pager reading the chain ahead of the cursor.
+	c.pager.PrefetchScan(rightPageNumber)
+	np := c.getPage(rightPageNumber)
 	c.moveToPage(np)
 	return true
 }
 
 func (c *Cursor) moveToPage(p *pager.Page) {
-	c.currentTupleKey = p.GetEntries()[0].Key
 	c.currentPage = p
+	c.moveToIndex(0)
+}
+
+// moveToIndex points the cursor at the i-th tuple on the current page. The
+// current key is copied out of the page buffer since the key must stay stable
+// while the page is mutated.
+func (c *Cursor) moveToIndex(i int) {
+	c.currentTupleIndex = i
+	c.currentTupleKey = slices.Clone(c.currentPage.GetTuple(i).Key)
 }
 
 // Count returns the count of the current b trees leaf node entries.
 //
-// Count does this not by scanning each individual tuple, but scanning each page
-// and summing the computed counter on the page.
+// Count does this not by scanning each individual tuple, but scanning each
+// page and summing the on page record counter. No tuple is copied or decoded
+// meaning the cost of a count is one page header read per leaf.
 func (c *Cursor) Count() int {
 	hasValues := c.GotoFirstRecord()
 	sum := 0
 	if !hasValues {
 		return sum
 	}
-	sum += len(c.currentPage.GetEntries())
+	sum += c.currentPage.GetRecordCount()
 	for c.gotoNextPage() {
-		sum += len(c.currentPage.GetEntries())
+		sum += c.currentPage.GetRecordCount()
 	}
 	return sum
 }
 
+// parallelCountWorkers is the maximum count of goroutines a parallel count
+// fans out to.
+var parallelCountWorkers = runtime.NumCPU()
+
+// ParallelCount returns the count of tuples in the btree like Count, but
+// partitions the leaf chain across worker goroutines each counting with its
+// own cursor. The chain is partitioned at the first leaf of each subtree
+// under the root and each worker counts the run of leaves up to the start of
+// another partition. The leaf chain is the authority on the tuples in the
+// tree since internal pages can hold stale pointers after splits. A non
+// snapshot cursor falls back to the sequential Count since its page reads can
+// populate the pager's dirty page set which is not guarded for concurrent
+// access.
+func (c *Cursor) ParallelCount() int {
+	if !c.snapshot {
+		return c.Count()
+	}
+	root := c.getPage(c.rootPageNumber)
+	if root.IsLeaf() {
+		return root.GetRecordCount()
+	}
+	// starts is the first leaf of each subtree under the root in tree order.
+	// The map form is shared by the workers to recognize the end of their run
+	// of leaves.
+	starts := []int{}
+	isStart := map[int]bool{}
+	for i := 0; i < root.GetRecordCount(); i += 1 {
+		leaf := c.leftmostLeaf(int(binary.LittleEndian.Uint32(root.GetTuple(i).Value)))
+		if !isStart[leaf] {
+			isStart[leaf] = true
+			starts = append(starts, leaf)
+		}
+	}
+	work := make(chan int, len(starts))
+	for _, s := range starts {
+		work <- s
+	}
+	close(work)
+	workers := min(parallelCountWorkers, len(starts))
+	sums := make(chan int, workers)
+	for i := 0; i < workers; i += 1 {
+		wc := c.kv.NewSnapshotCursor(c.rootPageNumber)
+		go func(wc *Cursor) {
+			sum := 0
+			for start := range work {
+				page := wc.getPage(start)
+				sum += page.GetRecordCount()
+				for {
+					hasRight, rightPageNumber := page.GetRightPageNumber()
+					if !hasRight || isStart[rightPageNumber] {
+						break
+					}
+					page = wc.getPage(rightPageNumber)
+					sum += page.GetRecordCount()
+				}
+			}
+			sums <- sum
+		}(wc)
+	}
+	total := 0
+	for i := 0; i < workers; i += 1 {
+		total += <-sums
+	}
+	return total
+}
+
+// leftmostLeaf descends to the first leaf of the subtree rooted at the given
+// page and returns its page number.
+func (c *Cursor) leftmostLeaf(pageNumber int) int {
+	page := c.getPage(pageNumber)
+	for !page.IsLeaf() {
+		v := page.GetTuple(0).Value
+		page = c.getPage(int(binary.LittleEndian.Uint32(v)))
+	}
+	return page.GetNumber()
+}
+
 // Exists will probe the specified key and return true or false if the key
 // exists or not.
 func (c *Cursor) Exists(key []byte) bool {
 	pageNumber := c.rootPageNumber
 	for {
-		page := c.pager.GetPage(pageNumber)
+		page := c.getPage(pageNumber)
 		v, found := page.GetValue(key)
 		if page.IsLeaf() {
 			return found
@@ -347,18 +920,33 @@ func (c *Cursor) Exists(key []byte) bool {
 }
 
 // NewRowID returns the highest unused key in a table for the rootPageNumber.
-// For a integer key it is the largest integer key plus one.
+// For a integer key it is the largest integer key plus one. The assigned
+// rowids are cached per root page in the kv layer so every call after the
+// first is a counter bump instead of a descent to the rightmost leaf.
 func (c *Cursor) NewRowID() int {
-	// TODO could possibly cache this in the catalog or on the cursor
-	candidate := c.pager.GetPage(c.rootPageNumber)
+	c.kv.maxRowIDMu.Lock()
+	defer c.kv.maxRowIDMu.Unlock()
+	if max, ok := c.kv.maxRowIDs[c.rootPageNumber]; ok {
+		c.kv.maxRowIDs[c.rootPageNumber] = max + 1
+		return max + 1
+	}
+	rid := c.maxRowID() + 1
+	c.kv.maxRowIDs[c.rootPageNumber] = rid
+	return rid
+}
+
+// maxRowID walks to the rightmost leaf and decodes the largest key in the
+// table. 0 means the table is empty.
+func (c *Cursor) maxRowID() int {
+	candidate := c.getPage(c.rootPageNumber)
 	if len(candidate.GetEntries()) == 0 {
-		return 1
+		return 0
 	}
 	for !candidate.IsLeaf() {
 		pagePointers := candidate.GetEntries()
 		descendingPageNum := pagePointers[len(pagePointers)-1].Value
 		descendingPageNum32 := binary.LittleEndian.Uint32(descendingPageNum)
-		candidate = c.pager.GetPage(int(descendingPageNum32))
+		candidate = c.getPage(int(descendingPageNum32))
 	}
 	k := candidate.GetEntries()[len(candidate.GetEntries())-1].Key
 	dk, err := DecodeKey(k)
@@ -369,7 +957,7 @@ func (c *Cursor) NewRowID() int {
 	if !ok {
 		log.Fatal("non integer key increment not supported")
 	}
-	return dki + 1
+	return dki
 }
 
 // Get returns a byte array corresponding to the key and a bool indicating if
@@ -379,10 +967,13 @@ func (c *Cursor) Get(key []byte) ([]byte, bool) {
 	// TODO improve interface to move the cursor instead of a one time point
 	pageNumber := c.rootPageNumber
 	for {
-		page := c.pager.GetPage(pageNumber)
+		page := c.getPage(pageNumber)
 		v, found := page.GetValue(key)
 		if page.IsLeaf() {
-			return v, found
+			if !found {
+				return v, found
+			}
+			return c.resolveValue(v), found
 		}
 		if !found {
 			return nil, false
@@ -394,9 +985,167 @@ func (c *Cursor) Get(key []byte) ([]byte, bool) {
 // Set inserts or updates the value for the given key. The pageNumber has to do
 // with the root page of the corresponding table. The system catalog uses the
 // page number 1.
-func (c *Cursor) Set(key, value []byte) {
+func (c *Cursor) Set(key, value []byte) error {
+	c.set(key, c.overflowValue(value))
+	return c.spill()
+}
+
+// BatchEntry is a key value pair destined for SetBatch.
+type BatchEntry struct {
+	Key   []byte
+	Value []byte
+}
+
+// SetBatch inserts or updates the given entries with one descent per target
+// leaf instead of one per entry. The entries are sorted by key and each found
+// leaf takes every consecutive entry belonging to it before the next descent.
+// Since the keys of a multi row insert are nearly always adjacent a batch
+// typically costs a single descent per filled leaf.
+func (c *Cursor) SetBatch(entries []BatchEntry) error {
+	slices.SortStableFunc(entries, func(a, b BatchEntry) int {
+		return bytes.Compare(a.Key, b.Key)
+	})
+	i := 0
+	for i < len(entries) {
+		leafPage := c.getLeafPage(c.rootPageNumber, entries[i].Key)
+		// An entry belongs to this leaf while it sorts before the right
+		// sibling's first key. The rightmost leaf takes every remaining
+		// entry.
+		var bound []byte
+		unbounded := true
+		if hasRight, rightPageNumber := leafPage.GetRightPageNumber(); hasRight {
+			unbounded = false
+			rightPage := c.getPage(rightPageNumber)
+			if rightPage.GetRecordCount() != 0 {
+				bound = rightPage.GetTuple(0).Key
+			}
+		}
+		processed := 0
+		for i < len(entries) {
+			key := entries[i].Key
+			if processed != 0 {
+				// The descent chose this leaf for the first entry. Later
+				// entries stay only while provably within the bound.
+				if !unbounded && (bound == nil || bytes.Compare(key, bound) != -1) {
+					break
+				}
+			}
+			value := c.overflowValue(entries[i].Value)
+			if old, exists := leafPage.GetValue(key); exists {
+				c.freeOverflow(old)
+			}
+			if !leafPage.CanInsertTuple(key, value) {
+				// The leaf is full. The single key path splits it and the
+				// remaining entries re-descend into the split result.
+				c.set(key, value)
+				i += 1
+				break
+			}
+			leafPage.SetValue(key, value)
+			processed += 1
+			i += 1
+		}
+		if err := c.spill(); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// maxLocalValueSize is the largest value stored inline in a B tree page. A
+// larger value is stored as a maxLocalValueSize prefix followed by the page
+// number of its overflow chain. This keeps the fan out of pages holding multi
+// kilobyte values high. Since an inline value never exceeds this size, a
+// stored value longer than it is always an overflowed value.
+const maxLocalValueSize = 512
+
+// overflowValue moves the remainder of a large value into a chain of overflow
+// pages and returns the value to store in the B tree page. A value within
+// maxLocalValueSize is returned as is. Overflow applies to databases with the
+// serial record format since older files can hold large inline values. A
+// replaced or deleted chain is returned to the free list by freeOverflow.
+func (c *Cursor) overflowValue(value []byte) []byte {
+	if len(value) <= maxLocalValueSize || c.kv.recordFormat == pager.RecordFormatGob {
+		return value
+	}
+	rest := value[maxLocalValueSize:]
+	capacity := c.pager.OverflowPageCapacity()
+	// The chain is built back to front so each page knows the page after it.
+	next := 0
+	for end := len(rest); end > 0; {
+		start := ((end - 1) / capacity) * capacity
+		op := c.pager.NewPage()
+		op.SetOverflowContent(rest[start:end])
+		op.SetRightPageNumber(next)
+		next = op.GetNumber()
+		end = start
+	}
+	local := make([]byte, maxLocalValueSize, maxLocalValueSize+4)
+	copy(local, value[:maxLocalValueSize])
+	return binary.LittleEndian.AppendUint32(local, uint32(next))
+}
+
+// resolveValue returns the full value for a value read from a B tree page. A
+// value longer than maxLocalValueSize is a prefix followed by the page number
+// of its overflow chain which is walked and joined.
+func (c *Cursor) resolveValue(v []byte) []byte {
+	if len(v) <= maxLocalValueSize || c.kv.recordFormat == pager.RecordFormatGob {
+		return v
+	}
+	full := append([]byte{}, v[:maxLocalValueSize]...)
+	pageNumber := int(binary.LittleEndian.Uint32(v[maxLocalValueSize:]))
+	for pageNumber != 0 {
+		op := c.getPage(pageNumber)
+		full = append(full, op.GetOverflowContent()...)
+		hasNext, next := op.GetRightPageNumber()
+		if !hasNext {
+			break
+		}
+		pageNumber = next
+	}
+	return full
+}
+
+// freeOverflow returns the overflow chain of a replaced or deleted value to
+// the free list. A value short enough to be stored inline has no chain.
+func (c *Cursor) freeOverflow(v []byte) {
+	if len(v) <= maxLocalValueSize || c.kv.recordFormat == pager.RecordFormatGob {
+		return
+	}
+	pageNumber := int(binary.LittleEndian.Uint32(v[maxLocalValueSize:]))
+	for pageNumber != 0 {
+		op := c.getPage(pageNumber)
+		// The next pointer is read before FreePage links the page into the
+		// free list through the same pointer.
+		hasNext, next := op.GetRightPageNumber()
+		c.pager.FreePage(op)
+		if !hasNext {
+			break
+		}
+		pageNumber = next
+	}
+}
+
+// spill bounds the memory held by the write transaction at an operation
+// boundary. The pager invalidates spilled pages so the cursor re-fetches its
+// current page afterwards.
+func (c *Cursor) spill() error {
+	if err := c.pager.SpillDirtyPages(); err != nil {
+		return err
+	}
+	if c.currentPage != nil {
+		c.currentPage = c.getPage(c.currentPage.GetNumber())
+	}
+	return nil
+}
+
+func (c *Cursor) set(key, value []byte) {
 	// Find leaf page with key as the search param.
 	leafPage := c.getLeafPage(c.rootPageNumber, key)
+	// A replaced value may own an overflow chain which would otherwise leak.
+	if old, exists := leafPage.GetValue(key); exists {
+		c.freeOverflow(old)
+	}
 	// If the leaf page can hold the new tuple be done.
 	if leafPage.CanInsertTuple(key, value) {
 		leafPage.SetValue(key, value)
@@ -411,7 +1160,7 @@ func (c *Cursor) Set(key, value []byte) {
 	if hasParent {
 		leftPage.SetParentPageNumber(parentPageNumber)
 		rightPage.SetParentPageNumber(parentPageNumber)
-		parentPage := c.pager.GetPage(parentPageNumber)
+		parentPage := c.getPage(parentPageNumber)
 		c.parentInsert(parentPage, leftPage, rightPage)
 		return
 	}
@@ -433,6 +1182,114 @@ func (c *Cursor) Set(key, value []byte) {
 	rightPage.SetParentPageNumber(leafPage.GetNumber())
 }
 
+// BulkSet is a fast path for Set when keys are inserted in ascending order.
+// The cursor caches the rightmost leaf and appends to it in constant time
+// instead of descending from the root and re-serializing the leaf for every
+// key. When the leaf fills a fresh rightmost leaf is allocated and the
+// internal levels are built bottom up meaning existing pages are never
+// rewritten. Keys that do not sort after every key in the tree fall back to
+// Set.
+func (c *Cursor) BulkSet(key, value []byte) error {
+	value = c.overflowValue(value)
+	leaf := c.bulkLeaf()
+	if rc := leaf.GetRecordCount(); rc != 0 {
+		if bytes.Compare(key, leaf.GetTuple(rc-1).Key) != 1 { // key <= last
+			c.bulkLeafPageNumber = 0
+			c.set(key, value)
+			return c.spill()
+		}
+	}
+	if leaf.CanAppendTuple(key, value) {
+		leaf.AppendTuple(key, value)
+	} else {
+		c.bulkAppendLeaf(leaf, key, value)
+	}
+	return c.spill()
+}
+
+// bulkLeaf returns the rightmost leaf which is cached between BulkSet calls.
+func (c *Cursor) bulkLeaf() *pager.Page {
+	if c.bulkLeafPageNumber != 0 {
+		return c.getPage(c.bulkLeafPageNumber)
+	}
+	p := c.getPage(c.rootPageNumber)
+	for !p.IsLeaf() {
+		nextPage := p.GetTuple(p.GetRecordCount() - 1).Value
+		p = c.getPage(int(binary.LittleEndian.Uint32(nextPage)))
+	}
+	c.bulkLeafPageNumber = p.GetNumber()
+	return p
+}
+
+// bulkAppendLeaf allocates a fresh rightmost leaf holding the tuple and
+// inserts the leaf pointer into the internal levels bottom up.
+func (c *Cursor) bulkAppendLeaf(leaf *pager.Page, key, value []byte) {
+	newLeaf := c.pager.NewPage()
+	newLeaf.AppendTuple(key, value)
+	c.bulkLeafPageNumber = newLeaf.GetNumber()
+	hasParent, parentPageNumber := leaf.GetParentPageNumber()
+	if !hasParent {
+		c.bulkRootSplit(leaf, key, newLeaf)
+		return
+	}
+	leaf.SetRightPageNumber(newLeaf.GetNumber())
+	newLeaf.SetLeftPageNumber(leaf.GetNumber())
+	c.bulkPointerInsert(c.getPage(parentPageNumber), key, newLeaf)
+}
+
+// bulkPointerInsert appends the pointer for the new rightmost child to the
+// parent. When the parent is full a fresh rightmost internal page is allocated
+// and the insert moves up a level. The key also separates the levels above
+// since every key in the child's subtree sorts after it.
+func (c *Cursor) bulkPointerInsert(parent *pager.Page, key []byte, child *pager.Page) {
+	v := child.GetNumberAsBytes()
+	if parent.CanAppendTuple(key, v) {
+		parent.AppendTuple(key, v)
+		child.SetParentPageNumber(parent.GetNumber())
+		return
+	}
+	newInternal := c.pager.NewPage()
+	newInternal.SetTypeInternal()
+	newInternal.AppendTuple(key, v)
+	child.SetParentPageNumber(newInternal.GetNumber())
+	hasParent, parentPageNumber := parent.GetParentPageNumber()
+	if !hasParent {
+		c.bulkRootSplit(parent, key, newInternal)
+		return
+	}
+	parent.SetRightPageNumber(newInternal.GetNumber())
+	newInternal.SetLeftPageNumber(parent.GetNumber())
+	c.bulkPointerInsert(c.getPage(parentPageNumber), key, newInternal)
+}
+
+// bulkRootSplit handles the rightmost page of a level being the root. The
+// root's entries move into a fresh left child and the root becomes internal
+// with two page pointers. This keeps the root page number the same so the
+// table catalog doesn't need to be updated every time a root node splits.
+func (c *Cursor) bulkRootSplit(root *pager.Page, key []byte, right *pager.Page) {
+	left := c.pager.NewPage()
+	left.SetType(root.GetType())
+	left.SetEntries(root.GetEntries())
+	// When the root is internal the children of the moved entries are
+	// re-parented under the new left page.
+	c.adoptChildren(left)
+	left.SetRightPageNumber(right.GetNumber())
+	right.SetLeftPageNumber(left.GetNumber())
+	root.SetTypeInternal()
+	root.SetEntries([]pager.PageTuple{
+		{
+			Key:   left.GetTuple(0).Key,
+			Value: left.GetNumberAsBytes(),
+		},
+		{
+			Key:   key,
+			Value: right.GetNumberAsBytes(),
+		},
+	})
+	left.SetParentPageNumber(root.GetNumber())
+	right.SetParentPageNumber(root.GetNumber())
+}
+
 // insertIntoOne is a helper function to insert into a left or right page given
 // the left and right pages have space and the right page is greater than the
 // left.
@@ -452,14 +1309,14 @@ func (c *Cursor) insertIntoOne(key, value []byte, lp, rp *pager.Page) {
 }
 
 func (c *Cursor) getLeafPage(nextPageNumber int, key []byte) *pager.Page {
-	p := c.pager.GetPage(nextPageNumber)
+	p := c.getPage(nextPageNumber)
 	for !p.IsLeaf() {
 		nextPage, found := p.GetValue(key)
 		if !found {
 			return nil
 		}
 		nextPageNumber32 := binary.LittleEndian.Uint32(nextPage)
-		p = c.pager.GetPage(int(nextPageNumber32))
+		p = c.getPage(int(nextPageNumber32))
 	}
 	return p
 }
@@ -486,7 +1343,7 @@ func (c *Cursor) splitPage(page *pager.Page) (left, right *pager.Page) {
 	rightPage.SetType(parentType)
 	// Set relative left page's right page
 	if parentLeftPageNumber != 0 {
-		c.pager.GetPage(parentLeftPageNumber).SetRightPageNumber(leftPage.GetNumber())
+		c.getPage(parentLeftPageNumber).SetRightPageNumber(leftPage.GetNumber())
 	}
 	// Set split left's left and right
 	leftPage.SetLeftPageNumber(parentLeftPageNumber)
@@ -496,7 +1353,7 @@ func (c *Cursor) splitPage(page *pager.Page) (left, right *pager.Page) {
 	rightPage.SetRightPageNumber(parentRightPageNumber)
 	// Set relative right page's left page
 	if parentRightPageNumber != 0 {
-		c.pager.GetPage(parentRightPageNumber).SetLeftPageNumber(rightPage.GetNumber())
+		c.getPage(parentRightPageNumber).SetLeftPageNumber(rightPage.GetNumber())
 	}
 	return leftPage, rightPage
 }
@@ -512,6 +1369,18 @@ func (c *Cursor) parentInsert(p, l, r *pager.Page) {
 	k2 := r.GetEntries()[0].Key
 	v2 := r.GetNumberAsBytes()
 	tuples := []pager.PageTuple{{Key: k1, Value: v1}, {Key: k2, Value: v2}}
+	// Deletes can lower a page's first key leaving the parent entry for the
+	// page keyed by a key that no longer exists. Such an entry would duplicate
+	// the pointer once the new separator key is set so it is dropped first.
+	kept := []pager.PageTuple{}
+	for _, e := range p.GetEntries() {
+		if !bytes.Equal(e.Value, v1) && !bytes.Equal(e.Value, v2) {
+			kept = append(kept, e)
+		}
+	}
+	if len(kept) != p.GetRecordCount() {
+		p.SetEntries(kept)
+	}
 	// If the parent is able to insert the page pointers we are done.
 	if p.CanInsertTuples(tuples) {
 		p.SetValue(k1, v1)
@@ -526,13 +1395,14 @@ func (c *Cursor) parentInsert(p, l, r *pager.Page) {
 	leftPage, rightPage := c.splitPage(p)
 	c.insertIntoOne(k1, v1, leftPage, rightPage)
 	c.insertIntoOne(k2, v2, leftPage, rightPage)
+	// The split moved pointer entries between the two pages meaning the
+	// children they reference are re-parented. This covers l and r as well
+	// since their pointers were just inserted.
+	c.adoptChildren(leftPage)
+	c.adoptChildren(rightPage)
 	hasParent, parentPageNumber := p.GetParentPageNumber()
 	if hasParent {
-		leftPage.SetParentPageNumber(parentPageNumber)
-		rightPage.SetParentPageNumber(parentPageNumber)
-		l.SetParentPageNumber(parentPageNumber)
-		r.SetParentPageNumber(parentPageNumber)
-		parentParent := c.pager.GetPage(parentPageNumber)
+		parentParent := c.getPage(parentPageNumber)
 		c.parentInsert(parentParent, leftPage, rightPage)
 		return
 	}
@@ -0,0 +1,90 @@
+package kv
+
+import (
+	"fmt"
+	"testing"
+)
+
+// benchRows is the size of the dataset the cursor benchmarks run against. It
+// is large enough for the tree to span many leaf pages.
+const benchRows = 10_000
+
+// benchCursor seeds a fresh memory backed tree with benchRows sequential rows
+// so each benchmark measures against the same fixed dataset.
+func benchCursor(b *testing.B) (*KV, *Cursor) {
+	kv, cursor := mustNewCursor(1)
+	kv.BeginWriteTransaction()
+	for i := 1; i <= benchRows; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			b.Fatal(err)
+		}
+		v, err := Encode([]any{i, fmt.Sprintf("row value %04d", i)})
+		if err != nil {
+			b.Fatal(err)
+		}
+		if err := cursor.BulkSet(k, v); err != nil {
+			b.Fatal(err)
+		}
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		b.Fatal(err)
+	}
+	return kv, cursor
+}
+
+func BenchmarkCursorGet(b *testing.B) {
+	_, cursor := benchCursor(b)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		k, err := EncodeKey(i%benchRows + 1)
+		if err != nil {
+			b.Fatal(err)
+		}
+		if _, found := cursor.Get(k); !found {
+			b.Fatalf("expected key %d to be found", i%benchRows+1)
+		}
+	}
+}
+
+func BenchmarkCursorScan(b *testing.B) {
+	_, cursor := benchCursor(b)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		count := 0
+		for exists := cursor.GotoFirstRecord(); exists; exists = cursor.GotoNext() {
+			count += 1
+		}
+		if count != benchRows {
+			b.Fatalf("expected %d rows got %d", benchRows, count)
+		}
+	}
+}
+
+// BenchmarkCursorSet appends past the seeded rows so the measurement includes
+// the page splits a sequential insert workload causes.
+func BenchmarkCursorSet(b *testing.B) {
+	kv, cursor := benchCursor(b)
+	value, err := Encode([]any{1, "row value insert"})
+	if err != nil {
+		b.Fatal(err)
+	}
+	kv.BeginWriteTransaction()
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		k, err := EncodeKey(benchRows + i + 1)
+		if err != nil {
+			b.Fatal(err)
+		}
+		if err := cursor.Set(k, value); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.StopTimer()
+	if err := kv.EndWriteTransaction(); err != nil {
+		b.Fatal(err)
+	}
+}
@@ -3,6 +3,7 @@ package kv
 import (
 	"bytes"
 	"log"
+	"strings"
 	"testing"
 )
 
@@ -135,6 +136,182 @@ func TestBulkInsertAndGet(t *testing.T) {
 	}
 }
 
+func TestBulkSet(t *testing.T) {
+	kv, cursor := mustNewCursor(1)
+
+	// bulk load ascending keys skipping 2 so the fallback can fill it in
+	amount := 100_000
+	kv.BeginWriteTransaction()
+	for i := 1; i <= amount; i += 1 {
+		if i == 2 {
+			continue
+		}
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, err := Encode([]any{i})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if err := cursor.BulkSet(k, v); err != nil {
+			t.Fatal(err)
+		}
+	}
+	// an out of order key falls back to the general path
+	k, err := EncodeKey(2)
+	if err != nil {
+		t.Fatal(err)
+	}
+	v, err := Encode([]any{2})
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := cursor.BulkSet(k, v); err != nil {
+		t.Fatal(err)
+	}
+	kv.EndWriteTransaction()
+
+	// probe min, the out of order key, middle, and max
+	for _, probe := range []int{1, 2, amount / 2, amount} {
+		pk, err := EncodeKey(probe)
+		if err != nil {
+			t.Fatal(err)
+		}
+		r, found := cursor.Get(pk)
+		if !found {
+			t.Fatalf("expected value for %d to be found", probe)
+		}
+		rv, err := Decode(r)
+		if err != nil {
+			t.Fatal(err)
+		}
+		rvi := rv[0].(int)
+		if rvi != probe {
+			t.Fatalf("want %d got %d", probe, rvi)
+		}
+	}
+
+	// a full scan sees every key in order
+	count := 0
+	for exists := cursor.GotoFirstRecord(); exists; exists = cursor.GotoNext() {
+		count += 1
+	}
+	if count != amount {
+		t.Fatalf("want %d records got %d", amount, count)
+	}
+}
+
+func TestSetBatch(t *testing.T) {
+	kv, cursor := mustNewCursor(1)
+
+	mustEntry := func(key, value int) BatchEntry {
+		k, err := EncodeKey(key)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, err := Encode([]any{value})
+		if err != nil {
+			t.Fatal(err)
+		}
+		return BatchEntry{Key: k, Value: v}
+	}
+
+	// even keys load first so the odd keys land mid leaf and force splits
+	amount := 10_000
+	kv.BeginWriteTransaction()
+	evens := []BatchEntry{}
+	for i := 2; i <= amount; i += 2 {
+		evens = append(evens, mustEntry(i, i))
+	}
+	if err := cursor.SetBatch(evens); err != nil {
+		t.Fatal(err)
+	}
+	odds := []BatchEntry{}
+	for i := 1; i <= amount; i += 2 {
+		odds = append(odds, mustEntry(i, i))
+	}
+	if err := cursor.SetBatch(odds); err != nil {
+		t.Fatal(err)
+	}
+	// a batch of existing keys updates in place
+	updates := []BatchEntry{}
+	for i := 1; i <= 3; i += 1 {
+		updates = append(updates, mustEntry(i, i+amount))
+	}
+	if err := cursor.SetBatch(updates); err != nil {
+		t.Fatal(err)
+	}
+	kv.EndWriteTransaction()
+
+	// probe min, an updated key, middle, and max
+	for _, probe := range []struct{ key, want int }{
+		{1, 1 + amount},
+		{2, 2 + amount},
+		{amount / 2, amount / 2},
+		{amount, amount},
+	} {
+		pk, err := EncodeKey(probe.key)
+		if err != nil {
+			t.Fatal(err)
+		}
+		r, found := cursor.Get(pk)
+		if !found {
+			t.Fatalf("expected value for %d to be found", probe.key)
+		}
+		rv, err := Decode(r)
+		if err != nil {
+			t.Fatal(err)
+		}
+		rvi := rv[0].(int)
+		if rvi != probe.want {
+			t.Fatalf("want %d got %d", probe.want, rvi)
+		}
+	}
+
+	// a full scan sees every key exactly once
+	count := 0
+	for exists := cursor.GotoFirstRecord(); exists; exists = cursor.GotoNext() {
+		count += 1
+	}
+	if count != amount {
+		t.Fatalf("want %d records got %d", amount, count)
+	}
+}
+
+func TestNewRowID(t *testing.T) {
+	kv, cursor := mustNewCursor(2)
+
+	// Seed keys 1, 2, 3.
+	kv.BeginWriteTransaction()
+	for i := 1; i <= 3; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		cursor.Set(k, []byte{1})
+	}
+	kv.EndWriteTransaction()
+
+	// The first call descends the tree and later calls bump the counter.
+	kv.BeginWriteTransaction()
+	if rid := cursor.NewRowID(); rid != 4 {
+		t.Fatalf("want rowid 4 got %d", rid)
+	}
+	if rid := cursor.NewRowID(); rid != 5 {
+		t.Fatalf("want rowid 5 got %d", rid)
+	}
+
+	// A rollback drops the cache so reserved but never inserted rowids are
+	// handed out again.
+	kv.RollbackWrite()
+	kv.BeginWriteTransaction()
+	if rid := cursor.NewRowID(); rid != 4 {
+		t.Fatalf("want rowid 4 after rollback got %d", rid)
+	}
+	kv.EndWriteTransaction()
+}
+
 func TestUpdateLoop(t *testing.T) {
 	kv := mustNewKv()
 
@@ -260,3 +437,199 @@ func TestUpdateLoopWithIf(t *testing.T) {
 	}
 	kv.EndReadTransaction()
 }
+
+func TestParallelCount(t *testing.T) {
+	kv, cursor := mustNewCursor(1)
+
+	amount := 50_000
+	kv.BeginWriteTransaction()
+	for i := 1; i <= amount; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, err := Encode([]any{i})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if err := cursor.BulkSet(k, v); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+
+	kv.BeginReadTransaction()
+	defer kv.EndReadTransaction()
+	sc := kv.NewSnapshotCursor(1)
+	if got := sc.ParallelCount(); got != amount {
+		t.Fatalf("expected parallel count %d got %d", amount, got)
+	}
+	// A non snapshot cursor falls back to the sequential count.
+	if got := kv.NewCursor(1).ParallelCount(); got != amount {
+		t.Fatalf("expected sequential count %d got %d", amount, got)
+	}
+}
+
+func TestOverflowValues(t *testing.T) {
+	kv, cursor := mustNewCursor(1)
+
+	big := strings.Repeat("x", 10_000)
+	amount := 50
+	kv.BeginWriteTransaction()
+	for i := 1; i <= amount; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, err := Encode([]any{i, big})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if err := cursor.Set(k, v); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+
+	kv.BeginReadTransaction()
+	defer kv.EndReadTransaction()
+	for i := 1; i <= amount; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, found := cursor.Get(k)
+		if !found {
+			t.Fatalf("expected key %d to be found", i)
+		}
+		d, err := Decode(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if d[0] != i || d[1] != big {
+			t.Fatalf("unexpected value for key %d", i)
+		}
+	}
+
+	// Only a prefix and the overflow chain pointer live in the leaf so the
+	// fan out of the tree stays high.
+	if !cursor.GotoFirstRecord() {
+		t.Fatal("expected values")
+	}
+	if l := len(cursor.currentPage.GetTuple(0).Value); l != maxLocalValueSize+4 {
+		t.Fatalf("expected inline value of %d bytes got %d", maxLocalValueSize+4, l)
+	}
+}
+
+func TestDeleteRebalance(t *testing.T) {
+	kv, cursor := mustNewCursor(1)
+	amount := 10_000
+	if err := kv.BeginWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+	for i := 1; i <= amount; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, err := Encode([]any{i})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if err := cursor.BulkSet(k, v); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+
+	countLeafPages := func() int {
+		c := kv.NewCursor(1)
+		if !c.GotoFirstRecord() {
+			return 0
+		}
+		pages := 1
+		for c.gotoNextPage() {
+			pages += 1
+		}
+		return pages
+	}
+	kv.BeginReadTransaction()
+	pagesBefore := countLeafPages()
+	kv.EndReadTransaction()
+
+	// Delete all but the last tenth of the keys.
+	if err := kv.BeginWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+	c := kv.NewCursor(1)
+	exists := c.GotoFirstRecord()
+	for deleted := 0; exists && deleted < amount*9/10; deleted += 1 {
+		if err := c.DeleteCurrent(); err != nil {
+			t.Fatal(err)
+		}
+		exists = c.GotoNext()
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+
+	kv.BeginReadTransaction()
+	if got := kv.NewCursor(1).Count(); got != amount/10 {
+		t.Fatalf("expected count %d after deletes got %d", amount/10, got)
+	}
+	for i := amount*9/10 + 1; i <= amount; i += 1 {
+		k, err := EncodeKey(i)
+		if err != nil {
+			t.Fatal(err)
+		}
+		v, found := kv.NewCursor(1).Get(k)
+		if !found {
+			t.Fatalf("expected to find key %d after deletes", i)
+		}
+		dv, err := Decode(v)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if dv[0].(int) != i {
+			t.Fatalf("expected value %d got %v", i, dv[0])
+		}
+	}
+	pagesAfter := countLeafPages()
+	kv.EndReadTransaction()
+	if pagesAfter >= pagesBefore/2 {
+		t.Fatalf(
+			"expected merged leaf chain got %d pages before and %d after",
+			pagesBefore,
+			pagesAfter,
+		)
+	}
+
+	// Deleting every key collapses the tree back to an empty leaf root.
+	if err := kv.BeginWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+	c = kv.NewCursor(1)
+	for exists := c.GotoFirstRecord(); exists; exists = c.GotoNext() {
+		if err := c.DeleteCurrent(); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := kv.EndWriteTransaction(); err != nil {
+		t.Fatal(err)
+	}
+	kv.BeginReadTransaction()
+	defer kv.EndReadTransaction()
+	if got := kv.NewCursor(1).Count(); got != 0 {
+		t.Fatalf("expected empty tree got count %d", got)
+	}
+	root := kv.NewCursor(1).getPage(1)
+	if !root.IsLeaf() {
+		t.Fatal("expected root to collapse back to a leaf")
+	}
+}
@@ -90,12 +90,16 @@ func cdb_prepare(prepareId *C.int, filename *C.char, sql *C.char, prepareErr **C
 	}
 }
 
-// cdb_close_statement cleans up a prepared statement.
+// cdb_close_statement cleans up a prepared statement. Closing releases the
+// rows and the transaction held by an executing statement.
 //
 //export cdb_close_statement
 func cdb_close_statement(prepareId C.int) {
-	p := int(prepareId)
-	delete(_plans, p)
+	pid := int(prepareId)
+	if p, ok := _plans[pid]; ok {
+		p.Close()
+	}
+	delete(_plans, pid)
 }
 
 // cdb_bind_int binds an int as the next available argument for the given
@@ -107,7 +111,7 @@ func cdb_bind_int(prepareId C.int, bound C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	p.Args = append(p.Args, int(bound))
+	p.BindInt(int(bound))
 	return C.int(0)
 }
 
@@ -120,12 +124,15 @@ func cdb_bind_string(prepareId C.int, bound *C.char) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	bs := C.GoString(bound)
-	p.Args = append(p.Args, bs)
+	p.BindString(C.GoString(bound))
 	return C.int(0)
 }
 
-// cdb_execute evaluates the given prepared statement.
+// cdb_execute evaluates the given prepared statement. The result rows stream
+// as cdb_result_row advances so memory stays bounded by one row. One row is
+// read ahead so errors raised before the first row, like compile errors, are
+// visible to cdb_result_err immediately. Errors raised mid stream surface once
+// cdb_result_row reaches them.
 //
 //export cdb_execute
 func cdb_execute(prepareId C.int) C.int {
@@ -133,8 +140,7 @@ func cdb_execute(prepareId C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	result := p.DB.Execute(p.Statement, p.Args)
-	p.Result = &result
+	p.Execute()
 	return C.int(0)
 }
 
@@ -148,9 +154,9 @@ func cdb_result_err(prepareId C.int, hasError *C.int, errMessage **C.char) C.int
 	if !ok {
 		return C.int(1)
 	}
-	if p.Result.Err != nil {
+	if err := p.Err(); err != nil {
 		*hasError = C.int(1)
-		em := p.Result.Err.Error()
+		em := err.Error()
 		*errMessage = C.CString(em)
 	}
 	return C.int(0)
@@ -166,10 +172,8 @@ func cdb_result_row(prepareId C.int, hasRow *C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	p.ResultIdx += 1
-	if p.ResultIdx < len(p.Result.ResultRows) {
+	if p.Step() {
 		*hasRow = C.int(1)
-		return C.int(0)
 	}
 	return C.int(0)
 }
@@ -183,7 +187,7 @@ func cdb_result_col_int(prepareId C.int, colIdx C.int, result *C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	r := p.Result.ResultRows[p.ResultIdx][int(colIdx)]
+	r := p.Column(int(colIdx))
 	ri, err := strconv.Atoi(*r)
 	if err != nil {
 		return C.int(1)
@@ -201,7 +205,7 @@ func cdb_result_col_string(prepareId C.int, colIdx C.int, result **C.char) C.int
 	if !ok {
 		return C.int(1)
 	}
-	r := p.Result.ResultRows[p.ResultIdx][int(colIdx)]
+	r := p.Column(int(colIdx))
 	*result = C.CString(*r)
 	return C.int(0)
 }
@@ -215,7 +219,7 @@ func cdb_result_col_count(prepareId C.int, result *C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	r := len(p.Result.ResultHeader)
+	r := len(p.ColumnNames())
 	*result = C.int(r)
 	return C.int(0)
 }
@@ -229,7 +233,7 @@ func cdb_result_col_name(prepareId C.int, colIdx C.int, result **C.char) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	r := p.Result.ResultHeader[colIdx]
+	r := p.ColumnNames()[colIdx]
 	*result = C.CString(r)
 	return C.int(0)
 }
@@ -253,7 +257,7 @@ func cdb_result_col_type(prepareId C.int, colIdx C.int, result *C.int) C.int {
 	if !ok {
 		return C.int(1)
 	}
-	t := p.Result.ResultTypes[colIdx]
+	t := p.ColumnTypes()[colIdx]
 	*result = C.int(t.ID)
 	return C.int(0)
 }
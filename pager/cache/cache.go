@@ -1,19 +1,42 @@
 package cache
 
-import "slices"
+import "sync"
+
+// lruEntry is a node in the intrusive doubly linked eviction list. Each cached
+// value carries its own list pointers so get, add, and evict are all O(1).
+type lruEntry struct {
+	key   int
+	value []byte
+	prev  *lruEntry
+	next  *lruEntry
+}
 
 // lruPageCache implements pageCache
 type lruPageCache struct {
-	cache map[int][]byte
-	// evictList maintains an ordered list of keys currently in the cache. The
-	// list is ordered by the least recently used item at the 0th index of the
-	// list.
-	evictList []int
-	maxSize   int
+	// mu guards the cache since concurrent snapshot readers share it.
+	mu    sync.Mutex
+	cache map[int]*lruEntry
+	// head is the most recently used entry of the eviction list. tail is the
+	// least recently used entry and is the next entry to be evicted.
+	head *lruEntry
+	tail *lruEntry
+	// maxSize is the maximum count of items that can be cached. When maxSize
+	// is 0 the count of items is not capped.
+	maxSize int
+	// maxBytes is the maximum total byte size of cached values. When maxBytes
+	// is 0 the byte size is not capped.
+	maxBytes int
+	// currentBytes is the total byte size of the currently cached values.
+	currentBytes int
 	// version maintains the "version" of the cache. When the version is
 	// incremented it invalidates the cache. When the version is checked and it
 	// is the same it means the cache is still valid.
 	version int
+	// hits counts lookups that found their key since the cache was created.
+	hits int
+	// misses counts lookups that did not find their key since the cache was
+	// created.
+	misses int
 }
 
 // NewLRU creates a LRU (least recently used) cache. This cache takes a maxSize
@@ -21,72 +44,171 @@ type lruPageCache struct {
 // cache is exceeded, the least recently used item will be evicted.
 func NewLRU(maxSize, version int) *lruPageCache {
 	return &lruPageCache{
-		cache:     map[int][]byte{},
-		evictList: []int{},
-		maxSize:   maxSize,
-		version:   version,
+		cache:   map[int]*lruEntry{},
+		maxSize: maxSize,
+		version: version,
+	}
+}
+
+// NewLRUBytes creates a LRU cache capped by the total byte size of its values
+// rather than a count of items. This allows the page cache to be sized to the
+// memory of the machine for example a multi gigabyte cache. When the maximum
+// byte size is exceeded, the least recently used items will be evicted until
+// the cache fits.
+func NewLRUBytes(maxBytes, version int) *lruPageCache {
+	return &lruPageCache{
+		cache:    map[int]*lruEntry{},
+		maxBytes: maxBytes,
+		version:  version,
 	}
 }
 
 // Get returns a bool indicating if the key was found and the value for the key.
 func (c *lruPageCache) Get(key int) (value []byte, hit bool) {
-	v, ok := c.cache[key]
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	e, ok := c.cache[key]
+	if !ok {
+		c.misses += 1
+		return nil, false
+	}
+	c.hits += 1
+	c.prioritize(e)
+	return e.value, true
+}
+
+// Peek returns the value for the key without counting a hit or miss and
+// without changing the eviction order. Peek lets the background prefetcher
+// check and follow cached pages without skewing the cache stats or evicting
+// pages the scanning cursor is about to use.
+func (c *lruPageCache) Peek(key int) (value []byte, hit bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	e, ok := c.cache[key]
 	if !ok {
 		return nil, false
 	}
-	c.prioritize(key)
-	return v, true
+	return e.value, true
+}
+
+// Stats returns the count of cache hits and misses since the cache was
+// created.
+func (c *lruPageCache) Stats() (hits, misses int) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	return c.hits, c.misses
 }
 
 // Add adds the key to the cache and prioritizes it. If a collision occurs, the
 // key will be prioritized and the value will be updated.
 func (c *lruPageCache) Add(key int, value []byte) {
-	if _, ok := c.cache[key]; ok {
-		c.prioritize(key)
-		c.cache[key] = value
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if e, ok := c.cache[key]; ok {
+		c.currentBytes += len(value) - len(e.value)
+		e.value = value
+		c.prioritize(e)
+		c.evictOverflow()
 		return
 	}
-	if c.maxSize == len(c.cache) {
-		c.evict()
+	e := &lruEntry{
+		key:   key,
+		value: value,
 	}
-	c.cache[key] = value
-	c.evictList = append(c.evictList, key)
+	c.cache[key] = e
+	c.currentBytes += len(value)
+	c.pushFront(e)
+	c.evictOverflow()
 }
 
 // Remove removes the key from the cache. If the key is not found it will be
 // ignored.
 func (c *lruPageCache) Remove(key int) {
-	if _, ok := c.cache[key]; ok {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if e, ok := c.cache[key]; ok {
 		delete(c.cache, key)
-		i := slices.Index(c.evictList, key)
-		c.evictList = slices.Delete(c.evictList, i, i+1)
+		c.unlink(e)
+		c.currentBytes -= len(e.value)
 	}
 }
 
 // Validate clears the cache if the candidateVersion doesn't match the cache
 // version. Otherwise the cache is left intact.
 func (c *lruPageCache) Validate(candidateVersion int) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
 	if candidateVersion == c.version {
 		return
 	}
-	c.cache = map[int][]byte{}
-	c.evictList = []int{}
+	c.cache = map[int]*lruEntry{}
+	c.head = nil
+	c.tail = nil
+	c.currentBytes = 0
 }
 
 // SetVersion sets the cache version. This can be updated after a write
 // eliminating the need to purge the cache for the writer process. Since the
 // writing process clears dirty pages.
 func (c *lruPageCache) SetVersion(newVersion int) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
 	c.version = newVersion
 }
 
-func (c *lruPageCache) prioritize(key int) {
-	i := slices.Index(c.evictList, key)
-	c.evictList = append(slices.Delete(c.evictList, i, i+1), key)
+// prioritize moves the entry to the front of the eviction list making it the
+// most recently used entry.
+func (c *lruPageCache) prioritize(e *lruEntry) {
+	if c.head == e {
+		return
+	}
+	c.unlink(e)
+	c.pushFront(e)
+}
+
+// evictOverflow evicts least recently used entries until the cache is within
+// its item count and byte size caps.
+func (c *lruPageCache) evictOverflow() {
+	for c.tail != nil {
+		overSize := c.maxSize != 0 && len(c.cache) > c.maxSize
+		overBytes := c.maxBytes != 0 && c.currentBytes > c.maxBytes
+		if !overSize && !overBytes {
+			return
+		}
+		c.evict()
+	}
 }
 
 func (c *lruPageCache) evict() {
-	evictKey := c.evictList[0]
-	c.evictList = c.evictList[1:]
-	delete(c.cache, evictKey)
+	e := c.tail
+	c.unlink(e)
+	delete(c.cache, e.key)
+	c.currentBytes -= len(e.value)
+}
+
+func (c *lruPageCache) pushFront(e *lruEntry) {
+	e.prev = nil
+	e.next = c.head
+	if c.head != nil {
+		c.head.prev = e
+	}
+	c.head = e
+	if c.tail == nil {
+		c.tail = e
+	}
+}
+
+func (c *lruPageCache) unlink(e *lruEntry) {
+	if e.prev != nil {
+		e.prev.next = e.next
+	} else {
+		c.head = e.next
+	}
+	if e.next != nil {
+		e.next.prev = e.prev
+	} else {
+		c.tail = e.prev
+	}
+	e.prev = nil
+	e.next = nil
 }
@@ -37,6 +37,29 @@ func TestCache(t *testing.T) {
 	}
 }
 
+func TestCacheBytes(t *testing.T) {
+	c := NewLRUBytes(8, 0)
+	c.Add(1, []byte{1, 1, 1, 1})
+	c.Add(2, []byte{2, 2, 2, 2})
+
+	c.Get(1)
+
+	c.Add(3, []byte{3, 3, 3, 3})
+
+	if cl := len(c.cache); cl != 2 {
+		t.Fatalf("expected cache size 2 got %d", cl)
+	}
+	if _, ok := c.cache[1]; !ok {
+		t.Fatal("expected cache[1] to be ok")
+	}
+	if _, ok := c.cache[3]; !ok {
+		t.Fatal("expected cache[3] to be ok")
+	}
+	if c.currentBytes != 8 {
+		t.Fatalf("expected 8 current bytes got %d", c.currentBytes)
+	}
+}
+
 func TestVersion(t *testing.T) {
 	v1 := 0
 	v2 := 1
@@ -0,0 +1,90 @@
+package pager
+
+// mmapStorage is a fileStorage whose reads can be served from a memory map of
+// the database file. A mapped read hands out a slice backed by the OS page
+// cache meaning no per page buffer allocation or copy and no warm up of the
+// LRU page cache after a process restart. This is intended for read mostly
+// workloads such as replicas.
+
+import (
+	"fmt"
+	"runtime"
+	"sync"
+	"syscall"
+)
+
+type mmapStorage struct {
+	*fileStorage
+	// mu guards the mapping since concurrent readers can trigger a remap when
+	// the file has grown.
+	mu sync.Mutex
+	// data is the current mapping of the database file.
+	data []byte
+	// retired holds previous mappings of the file. A mapping is never
+	// unmapped while the pager lives since slices handed out by ReadSliceAt
+	// point into it.
+	retired [][]byte
+}
+
+func newMmapStorage(filename string) (storage, error) {
+	if !(runtime.GOOS == "linux" || runtime.GOOS == "darwin") {
+		return nil, fmt.Errorf("mmap storage does not support %s", runtime.GOOS)
+	}
+	fs, err := newFileStorage(filename)
+	if err != nil {
+		return nil, err
+	}
+	ms := &mmapStorage{fileStorage: fs.(*fileStorage)}
+	ms.remap()
+	return ms, nil
+}
+
+// ReadSliceAt returns a slice of the database file without copying. The
+// second return is false when the range is not covered by the mapping for
+// example a page that has never been written. The mapping is read only
+// meaning a caller mutating the slice faults instead of corrupting the file.
+func (s *mmapStorage) ReadSliceAt(off int64, n int) ([]byte, bool) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if int(off)+n > len(s.data) {
+		s.remap()
+	}
+	if int(off)+n > len(s.data) {
+		return nil, false
+	}
+	return s.data[off : int(off)+n], true
+}
+
+// Truncate is a no op since shrinking the file under the mapping would fault
+// reads of retired mappings covering the truncated region. The tail is simply
+// never read since page allocation is governed by the free page counter.
+func (s *mmapStorage) Truncate(size int64) error {
+	return nil
+}
+
+// remap maps the current size of the database file. The previous mapping is
+// retired instead of unmapped so slices previously handed out stay valid.
+func (s *mmapStorage) remap() {
+	fi, err := s.file.Stat()
+	if err != nil {
+		return
+	}
+	size := int(fi.Size())
+	if size <= len(s.data) {
+		return
+	}
+	m, err := syscall.Mmap(
+		int(s.file.Fd()),
+		0,
+		size,
+		syscall.PROT_READ,
+		syscall.MAP_SHARED,
+	)
+	if err != nil {
+		return
+	}
+	if s.data != nil {
+		s.retired = append(s.retired, s.data)
+	}
+	s.data = m
+}
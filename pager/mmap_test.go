@@ -0,0 +1,50 @@
+package pager
+
+import (
+	"bytes"
+	"errors"
+	"os"
+	"testing"
+)
+
+func TestMmapStorage(t *testing.T) {
+	err := os.Remove("mmap_test.db")
+	if err != nil && !errors.Is(err, os.ErrNotExist) {
+		t.Fatal("could not remove existing mmap_test.db file")
+	}
+	pager, err := New(false, "mmap_test", WithMmap())
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	p := pager.GetPage(1)
+	p.SetValue([]byte{1}, []byte{'c', 'a', 'r', 'l'})
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found := pager.GetPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected found")
+	}
+	if !bytes.Equal(ret, []byte{'c', 'a', 'r', 'l'}) {
+		t.Errorf("expected carl got %v", ret)
+	}
+	pager.EndRead()
+
+	// Mapped reads are served by the OS page cache meaning the LRU page cache
+	// is not involved.
+	if hits, misses := pager.CacheStats(); hits != 0 || misses != 0 {
+		t.Errorf("expected no cache traffic got %d hits %d misses", hits, misses)
+	}
+
+	if err := os.Remove("mmap_test.db"); err != nil {
+		t.Fatal("failed to clean up mmap_test.db file")
+	}
+}
@@ -6,8 +6,9 @@ package pager
 import (
 	"bytes"
 	"encoding/binary"
-	"slices"
+	"fmt"
 	"sort"
+	"sync"
 
 	"github.com/chirst/cdb/pager/cache"
 )
@@ -36,6 +37,12 @@ const (
 	DefaultDBFileName = "cdb"
 	// pageCacheSize is maximum amount of pages that can be cached in memory.
 	pageCacheSize = 1000
+	// maxDirtyPages is the count of dirty pages a write transaction holds in
+	// memory before the dirty set is spilled to the write ahead log.
+	maxDirtyPages = 1000
+	// prefetchDepth is the count of right linked pages read ahead of a
+	// sequential scan when a cursor hints one.
+	prefetchDepth = 16
 )
 
 // File header constants
@@ -51,6 +58,24 @@ const (
 	// fileChangeCounterSize is a uint32 since the counter needs to be
 	// reasonably big to guarantee uniqueness.
 	fileChangeCounterSize = 4
+	// recordFormatOffset is the offset of the record format version byte. The
+	// version selects how the kv layer encodes record values and is stamped
+	// when the database is created.
+	recordFormatOffset = fileChangeCounterOffset + fileChangeCounterSize
+	// recordFormatSize is a uint8.
+	recordFormatSize = 1
+	// pageSizeOffset is the offset of the page size. The size is stamped when
+	// the database is created and is fixed for the life of the file.
+	pageSizeOffset = recordFormatOffset + recordFormatSize
+	// pageSizeSize is a uint32.
+	pageSizeSize = 4
+	// freeListHeadOffset is the offset of the page number heading the free
+	// list. Freed pages chain through their right pointer and are reused by
+	// NewPage before the file is grown.
+	freeListHeadOffset = pageSizeOffset + pageSizeSize
+	// freeListHeadSize is a uint32 and must match the size of the page pointer
+	// size.
+	freeListHeadSize = 4
 	// rootPageStart marks the end of the file header. Unused space is reserved
 	// for future header additions since changing the size of the header breaks
 	// existing files.
@@ -59,21 +84,33 @@ const (
 
 // Page constants
 const (
-	// pageSize is the byte size of a single page. This size is used to
-	// calculate the offset for each block.
+	// defaultPageSize is the byte size of a single page unless a size is
+	// chosen with WithPageSize when the database is created.
 	//
-	// The capacity of the database can be calculated with the pageSize and the
-	// PAGE_POINTER_SIZE. For example 4096 * 4,294,967,295 = 1.7592186e+13 bytes
-	// which is 17.5 Terabytes. This number could be much larger given the page
-	// size was increased. It is eventually limited to the size of a file
-	// allowed by the operating system.
-	pageSize = 4096
+	// The capacity of the database can be calculated with the page size and
+	// the PAGE_POINTER_SIZE. For example 4096 * 4,294,967,295 = 1.7592186e+13
+	// bytes which is 17.5 Terabytes. This number could be much larger given
+	// the page size was increased. It is eventually limited to the size of a
+	// file allowed by the operating system.
+	defaultPageSize = 4096
+	// minPageSize is the smallest page size a database can be created with.
+	minPageSize = 512
+	// maxPageSize is the largest page size a database can be created with.
+	// Tuple offsets are a uint16 meaning offsets into a larger page could not
+	// be represented.
+	maxPageSize = 65536
 	// pageTypeUnknown is an invalid type.
 	pageTypeUnknown = 0
 	// pageTypeInternal is a page representing a B tree internal node.
 	pageTypeInternal = 1
 	// pageTypeLeaf is a page representing a B tree leaf.
-	pageTypeLeaf   = 2
+	pageTypeLeaf = 2
+	// pageTypeOverflow is a page holding the overflowed remainder of a tuple
+	// value too large to store in a B tree page.
+	pageTypeOverflow = 3
+	// pageTypeFree is a page on the free list waiting to be reused. The right
+	// pointer holds the next free page.
+	pageTypeFree   = 4
 	pageTypeOffset = 0
 	// pageTypeSize is a uint8
 	pageTypeSize = 1
@@ -99,10 +136,12 @@ const (
 // pageCache defines the page caching interface.
 type pageCache interface {
 	Get(int) ([]byte, bool)
+	Peek(int) ([]byte, bool)
 	Add(int, []byte)
 	Remove(int)
 	Validate(int)
 	SetVersion(int)
+	Stats() (hits, misses int)
 }
 
 // Pager is an abstraction of the database file. Pager handles efficiently
@@ -119,39 +158,318 @@ type Pager struct {
 	// the pages as dirty so the pages can be flushed to disk before the write
 	// lock is released.
 	isWriting bool
-	// dirtyPages is a list of pages that need to be flushed to disk in order
-	// for a write to be considered complete.
-	// TODO dirtyPages will eventually stack up. Need to have a mechanism to
-	// flush them once they reach a certain limit.
-	dirtyPages []*Page
+	// dirtyPages maps a page number to a page that needs to be flushed to
+	// disk in order for a write to be considered complete. In wal mode the
+	// dirty set is spilled to the log as uncommitted frames once it exceeds
+	// maxDirtyPages.
+	dirtyPages map[int]*Page
 	// pageCache caches frequently used pages to reduce expensive reads from
 	// the filesystem.
 	pageCache pageCache
+	// journalMode selects how commits are made atomic.
+	journalMode JournalMode
+	// wal is the write ahead log. It is nil unless the journal mode is
+	// JournalModeWal.
+	wal *wal
+	// snapshotMu excludes snapshot readers from the flush portion of a commit.
+	// Snapshot readers hold the read side for the duration of their read
+	// transaction. The flush holds the write side while it mutates storage.
+	snapshotMu sync.RWMutex
+	// readerMu guards isWriting and snapshotReaders so readers can atomically
+	// decide between a locked read and a snapshot read.
+	readerMu sync.Mutex
+	// snapshotReaders is the count of active snapshot read transactions.
+	snapshotReaders int
+	// recordFormat is the record format version the database file was created
+	// with.
+	recordFormat int
+	// pageSize is the byte size of a single page. The size is chosen when the
+	// database is created and read back from the file header afterwards.
+	pageSize int
+	// freeListHead is the page number heading the list of freed pages or 0
+	// when no pages are free. NewPage pops from the list before growing the
+	// file.
+	freeListHead int
+	// truncateOnFlush is true when the write transaction compacted the file
+	// meaning the flush should truncate the file to the last allocated page.
+	truncateOnFlush bool
+	// fileChangeCounter is the file change counter as last observed while
+	// holding the file lock. Layers above the pager compare this between write
+	// transactions to invalidate their own caches when another process has
+	// changed the file.
+	fileChangeCounter int
+	// asyncMu guards asyncCommitted and asyncErr. It is needed in addition to
+	// the file lock since snapshot readers access the committed set without
+	// holding the file lock.
+	asyncMu sync.Mutex
+	// asyncCommitted holds pages of committed transactions waiting to be
+	// flushed by the background flush. It is nil unless the pager was created
+	// with WithAsyncCommit. The committed pages shadow the page cache and the
+	// file until the flush writes them.
+	asyncCommitted map[int]*Page
+	// asyncNotify wakes the background flush after a commit. The channel is
+	// buffered with a single element so commits arriving while a flush is in
+	// progress coalesce into one pending flush.
+	asyncNotify chan struct{}
+	// asyncErr is the error of a failed background flush. It is surfaced by
+	// the next commit or Flush since the failing commit was already
+	// acknowledged.
+	asyncErr error
+	// maxPageAtBegin is the value of currentMaxPage when the write transaction
+	// began so a rollback in async commit mode can restore it without reading
+	// the possibly stale file header.
+	maxPageAtBegin int
+	// freeListHeadAtBegin is the value of freeListHead when the write
+	// transaction began.
+	freeListHeadAtBegin int
+	// prefetchCh carries leaf chain scan hints to the background prefetcher.
+	// The channel is buffered with a single element so hints arriving while a
+	// prefetch is in progress coalesce into one pending prefetch.
+	prefetchCh chan int
+}
+
+// Record format constants
+const (
+	// RecordFormatGob identifies record values encoded with encoding/gob.
+	// Files created before the record format byte existed read as this format
+	// since their header byte is zero.
+	RecordFormatGob = 0
+	// RecordFormatSerial identifies record values encoded with the compact
+	// serial type format in the kv package.
+	RecordFormatSerial = 1
+)
+
+// JournalMode selects how the pager makes commits atomic.
+type JournalMode int
+
+const (
+	// JournalModeRollback journals with a rollback journal file that is
+	// created before pages are flushed into the database file and removed
+	// once the flush is complete.
+	JournalModeRollback JournalMode = iota
+	// JournalModeWal journals by appending committed pages to a write ahead
+	// log that is periodically checkpointed into the database file.
+	JournalModeWal
+)
+
+// Option configures optional behavior of a pager created by New.
+type Option func(*pagerConfig)
+
+// pagerConfig holds the configurable pager settings with their defaults.
+type pagerConfig struct {
+	pageCacheSize  int
+	pageCacheBytes int
+	journalMode    JournalMode
+	useMmap        bool
+	pageSize       int
+	asyncCommit    bool
+}
+
+// WithAsyncCommit relaxes durability in exchange for write throughput. A
+// commit is acknowledged once the dirty pages land in an in memory committed
+// set and a background goroutine flushes the set to storage, batching the
+// pages of multiple transactions into one journal cycle. A crash loses the
+// transactions committed since the last flush but never corrupts the file
+// since the flush itself remains atomic. The mode assumes a single process
+// owns the file since the committed set is invisible to other processes.
+func WithAsyncCommit() Option {
+	return func(c *pagerConfig) {
+		c.asyncCommit = true
+	}
+}
+
+// WithPageSize selects the page size a new database is created with. The size
+// must be a power of two between 512 and 65536. Larger pages favor scan heavy
+// workloads since a sequential read costs fewer page reads while smaller pages
+// favor write heavy workloads since a dirtied page costs less to flush. The
+// size is stamped in the file header when the database is created and the
+// option is ignored for an existing database which keeps the size it was
+// created with.
+func WithPageSize(size int) Option {
+	return func(c *pagerConfig) {
+		c.pageSize = size
+	}
+}
+
+// WithMmap backs the database file with a memory map so reads are served
+// directly from the OS page cache instead of being copied through the LRU
+// page cache. This is intended for read mostly workloads such as replicas.
+func WithMmap() Option {
+	return func(c *pagerConfig) {
+		c.useMmap = true
+	}
+}
+
+// WithJournalMode selects the journaling mode the pager commits with.
+func WithJournalMode(m JournalMode) Option {
+	return func(c *pagerConfig) {
+		c.journalMode = m
+	}
+}
+
+// WithPageCacheSize overrides the default maximum count of pages held by the
+// page cache.
+func WithPageCacheSize(countPages int) Option {
+	return func(c *pagerConfig) {
+		c.pageCacheSize = countPages
+	}
+}
+
+// WithPageCacheBytes caps the page cache by the total byte size of cached
+// pages instead of a count of pages. This allows the cache to be sized to the
+// memory of the machine.
+func WithPageCacheBytes(maxBytes int) Option {
+	return func(c *pagerConfig) {
+		c.pageCacheBytes = maxBytes
+	}
 }
 
 // New creates a new pager. The useMemory flag means the database will not
 // create a file or persist changes to disk. This is useful for testing
 // purposes.
-func New(useMemory bool, filename string) (*Pager, error) {
+func New(useMemory bool, filename string, opts ...Option) (*Pager, error) {
+	config := &pagerConfig{
+		pageCacheSize: pageCacheSize,
+	}
+	for _, o := range opts {
+		o(config)
+	}
 	var s storage
 	var err error
 	if useMemory {
 		s = newMemoryStorage()
+	} else if config.useMmap {
+		s, err = newMmapStorage(filename)
 	} else {
 		s, err = newFileStorage(filename)
 	}
 	if err != nil {
 		return nil, err
 	}
+	ps, err := allocatePageSize(s, config.pageSize)
+	if err != nil {
+		return nil, err
+	}
+	var w *wal
+	if config.journalMode == JournalModeWal {
+		ws, err := newWalStore(useMemory, filename)
+		if err != nil {
+			return nil, err
+		}
+		w, err = newWal(ws, ps)
+		if err != nil {
+			return nil, err
+		}
+		// Committed frames left over from a previous session or a crash are
+		// checkpointed into the database file before it is read.
+		if w.frameCount != 0 {
+			if err := w.checkpoint(s); err != nil {
+				return nil, err
+			}
+		}
+	}
+	var pc pageCache
+	if config.pageCacheBytes != 0 {
+		pc = cache.NewLRUBytes(config.pageCacheBytes, readFileChangeCounter(s))
+	} else {
+		pc = cache.NewLRU(config.pageCacheSize, readFileChangeCounter(s))
+	}
 	p := &Pager{
 		store:          s,
 		currentMaxPage: allocateFreePageCounter(s),
-		dirtyPages:     []*Page{},
-		pageCache:      cache.NewLRU(pageCacheSize, readFileChangeCounter(s)),
+		dirtyPages:     map[int]*Page{},
+		pageCache:      pc,
+		journalMode:    config.journalMode,
+		wal:            w,
+		recordFormat:   allocateRecordFormat(s),
+		pageSize:       ps,
+		freeListHead:   readFreeListHead(s),
 	}
+	if config.asyncCommit {
+		if config.journalMode == JournalModeWal {
+			return nil, fmt.Errorf("async commit is not supported in wal journal mode")
+		}
+		p.asyncCommitted = map[int]*Page{}
+		p.asyncNotify = make(chan struct{}, 1)
+		go p.flushLoop()
+	}
+	p.prefetchCh = make(chan int, 1)
+	go p.prefetchLoop()
 	return p, nil
 }
 
+// allocateRecordFormat reads the record format version from the file header. A
+// fresh database is stamped with the current format. An existing database
+// keeps the format it was created with so files created before the version
+// byte existed keep decoding as gob.
+func allocateRecordFormat(s storage) int {
+	fb := make([]byte, freePageCounterSize)
+	s.ReadAt(fb, freePageCounterOffset)
+	if int(binary.LittleEndian.Uint32(fb)) == emptyParentPageNumber {
+		// The free page counter has never been set meaning the database has
+		// never been written to.
+		s.WriteAt([]byte{RecordFormatSerial}, recordFormatOffset)
+		return RecordFormatSerial
+	}
+	b := make([]byte, recordFormatSize)
+	s.ReadAt(b, recordFormatOffset)
+	return int(b[0])
+}
+
+// allocatePageSize reads the page size from the file header. A fresh database
+// is stamped with the requested size or the default when no size was
+// requested. An existing database keeps the size it was created with and the
+// requested size is ignored since the page layout arithmetic of existing
+// pages depends on the stamped size. Files created before the page size was
+// stamped read as the default size.
+func allocatePageSize(s storage, requested int) (int, error) {
+	if requested == 0 {
+		requested = defaultPageSize
+	}
+	if requested < minPageSize || maxPageSize < requested || requested&(requested-1) != 0 {
+		return 0, fmt.Errorf(
+			"page size %d must be a power of two between %d and %d",
+			requested,
+			minPageSize,
+			maxPageSize,
+		)
+	}
+	fb := make([]byte, freePageCounterSize)
+	s.ReadAt(fb, freePageCounterOffset)
+	if int(binary.LittleEndian.Uint32(fb)) == emptyParentPageNumber {
+		// The free page counter has never been set meaning the database has
+		// never been written to.
+		psb := make([]byte, pageSizeSize)
+		binary.LittleEndian.PutUint32(psb, uint32(requested))
+		s.WriteAt(psb, pageSizeOffset)
+		return requested, nil
+	}
+	b := make([]byte, pageSizeSize)
+	s.ReadAt(b, pageSizeOffset)
+	stamped := int(binary.LittleEndian.Uint32(b))
+	if stamped == 0 {
+		return defaultPageSize, nil
+	}
+	return stamped, nil
+}
+
+// RecordFormat returns the record format version the database was created
+// with.
+func (p *Pager) RecordFormat() int {
+	return p.recordFormat
+}
+
+// PageSize returns the byte size of a single page in the database file.
+func (p *Pager) PageSize() int {
+	return p.pageSize
+}
+
+// CacheStats returns the count of page cache hits and misses since the pager
+// was created.
+func (p *Pager) CacheStats() (hits, misses int) {
+	return p.pageCache.Stats()
+}
+
 // Read the free page counter from the file header.
 func allocateFreePageCounter(s storage) int {
 	fb := make([]byte, freePageCounterSize)
@@ -172,6 +490,20 @@ func (p *Pager) writeFreePageCounter() {
 	p.store.WriteAt(fb, freePageCounterOffset)
 }
 
+// readFreeListHead reads the head of the free list from the file header.
+func readFreeListHead(s storage) int {
+	b := make([]byte, freeListHeadSize)
+	s.ReadAt(b, freeListHeadOffset)
+	return int(binary.LittleEndian.Uint32(b))
+}
+
+// writeFreeListHead writes the head of the free list to the file header.
+func (p *Pager) writeFreeListHead() {
+	b := make([]byte, freeListHeadSize)
+	binary.LittleEndian.PutUint32(b, uint32(p.freeListHead))
+	p.store.WriteAt(b, freeListHeadOffset)
+}
+
 // readFileChangeCounter reads the current file change version. The counter is
 // incremented by 1 each time the database file changes. This means the counter
 // can be used to invalidate the page cache to prevent dirty reads caused by
@@ -192,6 +524,7 @@ func (p *Pager) incrementFileChangeCounter() {
 	b := make([]byte, fileChangeCounterSize)
 	binary.LittleEndian.PutUint32(b, newCount)
 	p.store.WriteAt(b, fileChangeCounterOffset)
+	p.fileChangeCounter = int(newCount)
 	// Because incrementFileChangeCounter is called within the write process
 	// that invalidates dirty pages from the cache it can be assumed the cache
 	// version can be updated. This allows any cached pages surviving the write
@@ -201,7 +534,24 @@ func (p *Pager) incrementFileChangeCounter() {
 
 // BeginRead starts a read transaction. Other readers will be able to access the
 // database file.
+//
+// When a writer in the same process is preparing its dirty page set the reader
+// becomes a snapshot reader. Snapshot readers continue against the pre commit
+// page versions without waiting for the writer and only exclude the flush
+// portion of a commit. The writer holds the exclusive file lock for the whole
+// write transaction which keeps other processes from changing the file under
+// the snapshot.
 func (p *Pager) BeginRead() error {
+	p.readerMu.Lock()
+	if p.isWriting {
+		// The flush clears isWriting before taking the write side of
+		// snapshotMu so this cannot block while readerMu is held.
+		p.snapshotMu.RLock()
+		p.snapshotReaders += 1
+		p.readerMu.Unlock()
+		return nil
+	}
+	p.readerMu.Unlock()
 	err := p.store.GetLock().RLock()
 	if err != nil {
 		return err
@@ -212,32 +562,78 @@ func (p *Pager) BeginRead() error {
 
 // EndRead ends a read transaction.
 func (p *Pager) EndRead() {
+	p.readerMu.Lock()
+	if p.snapshotReaders > 0 {
+		p.snapshotReaders -= 1
+		p.readerMu.Unlock()
+		p.snapshotMu.RUnlock()
+		return
+	}
+	p.readerMu.Unlock()
 	p.store.GetLock().RUnlock()
 }
 
 // BeginWrite starts a write transaction. If there are active readers this will
 // go into a pending state. When there is a pending writer no new readers will
 // be able to acquire a lock. Once all of the readers have finished this will
-// acquire exclusive access to the database file.
+// acquire exclusive access to the database file. Readers in the same process
+// arriving during the write transaction proceed as snapshot readers and are
+// not blocked.
 func (p *Pager) BeginWrite() error {
 	err := p.store.GetLock().Lock()
 	if err != nil {
 		return err
 	}
-	p.pageCache.Validate(readFileChangeCounter(p.store))
+	p.fileChangeCounter = readFileChangeCounter(p.store)
+	p.pageCache.Validate(p.fileChangeCounter)
+	p.maxPageAtBegin = p.currentMaxPage
+	p.freeListHeadAtBegin = p.freeListHead
+	p.readerMu.Lock()
 	p.isWriting = true
+	p.readerMu.Unlock()
 	return nil
 }
 
-// EndWrite creates a copy of the database called a journal. EndWrite proceeds
-// to write pages to disk and removes the journal after all pages have been
+// FileChangeCounter returns the file change counter as last observed while
+// holding the file lock. During a write transaction this is stable since the
+// exclusive lock keeps other processes from changing the file.
+func (p *Pager) FileChangeCounter() int {
+	return p.fileChangeCounter
+}
+
+// EndWrite commits the dirty pages with the configured journal mode.
+//
+// In rollback journal mode EndWrite creates a journal, writes the dirty pages
+// into the database file, and removes the journal after all pages have been
 // written. If there is a crash while the pages are being written the journal
 // will be promoted to the main database file the next time the db is started.
 // This enables the database to write atomically.
+//
+// In wal mode EndWrite appends the dirty pages to the write ahead log making
+// the commit cost proportional to the count of dirty pages. The log is
+// checkpointed into the database file once it holds enough frames.
+//
+// In async commit mode EndWrite only moves the dirty pages into the in memory
+// committed set and wakes the background flush meaning the commit is
+// acknowledged before it is durable.
 func (p *Pager) EndWrite() error {
 	if !p.isWriting {
 		return nil
 	}
+	if p.asyncCommitted != nil {
+		return p.endWriteAsync()
+	}
+	if p.journalMode == JournalModeWal {
+		return p.endWriteWal()
+	}
+	return p.flushJournal()
+}
+
+// flushJournal flushes the dirty pages into the database file with one
+// rollback journal cycle.
+func (p *Pager) flushJournal() error {
+	p.beginFlush()
+	defer p.snapshotMu.Unlock()
 	if err := p.store.CreateJournal(); err != nil {
 		return err
 	}
@@ -245,14 +641,142 @@ func (p *Pager) EndWrite() error {
 		p.writePage(fp)
 		p.pageCache.Remove(fp.GetNumber())
 	}
-	p.dirtyPages = []*Page{}
+	p.dirtyPages = map[int]*Page{}
 	p.writeFreePageCounter()
+	p.writeFreeListHead()
 	p.incrementFileChangeCounter()
+	p.truncateTail()
 	if err := p.store.DeleteJournal(); err != nil {
 		// TODO what can be done to gracefully handle a journal deletion failure
 		return err
 	}
+	if p.asyncCommitted != nil {
+		// Commits cannot interleave while the file lock is held meaning the
+		// flushed pages are exactly the committed set.
+		p.asyncMu.Lock()
+		p.asyncCommitted = map[int]*Page{}
+		p.asyncMu.Unlock()
+	}
+	p.store.GetLock().Unlock()
+	return nil
+}
+
+// endWriteAsync commits the dirty pages by moving them into the in memory
+// committed set. The pages shadow the page cache and the file until the
+// background flush writes them. An error of a previous background flush is
+// returned since the commit it belonged to was already acknowledged.
+func (p *Pager) endWriteAsync() error {
+	p.beginFlush()
+	defer p.snapshotMu.Unlock()
+	p.asyncMu.Lock()
+	err := p.asyncErr
+	p.asyncErr = nil
+	for pn, fp := range p.dirtyPages {
+		p.asyncCommitted[pn] = fp
+		p.pageCache.Remove(pn)
+	}
+	p.asyncMu.Unlock()
+	p.dirtyPages = map[int]*Page{}
+	p.store.GetLock().Unlock()
+	select {
+	case p.asyncNotify <- struct{}{}:
+	default:
+	}
+	return err
+}
+
+// flushLoop runs in a background goroutine flushing the committed set to
+// storage. A single flush covers every transaction committed since the
+// previous flush meaning a burst of commits is batched into one journal
+// cycle.
+func (p *Pager) flushLoop() {
+	for range p.asyncNotify {
+		if err := p.flushCommitted(); err != nil {
+			p.asyncMu.Lock()
+			p.asyncErr = err
+			p.asyncMu.Unlock()
+		}
+	}
+}
+
+// flushCommitted flushes the committed set with one journal cycle.
+func (p *Pager) flushCommitted() error {
+	p.asyncMu.Lock()
+	empty := len(p.asyncCommitted) == 0
+	p.asyncMu.Unlock()
+	if empty {
+		return nil
+	}
+	if err := p.BeginWrite(); err != nil {
+		return err
+	}
+	p.asyncMu.Lock()
+	for pn, fp := range p.asyncCommitted {
+		p.dirtyPages[pn] = fp
+	}
+	p.asyncMu.Unlock()
+	if len(p.dirtyPages) == 0 {
+		// Another flush emptied the committed set while this one was waiting
+		// on the file lock.
+		p.RollbackWrite()
+		return nil
+	}
+	return p.flushJournal()
+}
+
+// Flush blocks until the transactions committed in memory are flushed to
+// storage. Flush is a no op unless the pager was created with
+// WithAsyncCommit.
+func (p *Pager) Flush() error {
+	if p.asyncCommitted == nil {
+		return nil
+	}
+	if err := p.flushCommitted(); err != nil {
+		return err
+	}
+	p.asyncMu.Lock()
+	defer p.asyncMu.Unlock()
+	err := p.asyncErr
+	p.asyncErr = nil
+	return err
+}
+
+// beginFlush transitions the write transaction into the flush that mutates
+// storage. New readers fall back to waiting on the file lock and active
+// snapshot readers are drained before the flush proceeds.
+func (p *Pager) beginFlush() {
+	p.readerMu.Lock()
 	p.isWriting = false
+	p.readerMu.Unlock()
+	p.snapshotMu.Lock()
+}
+
+// endWriteWal commits the dirty pages by appending them to the write ahead
+// log.
+func (p *Pager) endWriteWal() error {
+	p.beginFlush()
+	defer p.snapshotMu.Unlock()
+	if err := p.wal.appendPages(p.dirtyPages, p.currentMaxPage); err != nil {
+		return err
+	}
+	for _, fp := range p.dirtyPages {
+		p.pageCache.Remove(fp.GetNumber())
+	}
+	p.dirtyPages = map[int]*Page{}
+	p.writeFreePageCounter()
+	p.writeFreeListHead()
+	p.incrementFileChangeCounter()
+	if p.truncateOnFlush {
+		// Frames for pages beyond the compacted end would re-extend the file
+		// when they are checkpointed.
+		p.wal.dropFramesAbove(p.currentMaxPage)
+	}
+	p.truncateTail()
+	if p.wal.frameCount >= walCheckpointThreshold {
+		if err := p.wal.checkpoint(p.store); err != nil {
+			return err
+		}
+	}
 	p.store.GetLock().Unlock()
 	return nil
 }
@@ -263,65 +787,275 @@ func (p *Pager) RollbackWrite() {
 	if !p.isWriting {
 		return
 	}
-	p.dirtyPages = []*Page{}
-	allocateFreePageCounter(p.store)
-	p.isWriting = false
+	p.dirtyPages = map[int]*Page{}
+	if p.wal != nil {
+		p.wal.dropSpilled()
+	}
+	if p.asyncCommitted != nil {
+		// The in memory committed state shadows the file header until the
+		// background flush writes it.
+		p.currentMaxPage = p.maxPageAtBegin
+		p.freeListHead = p.freeListHeadAtBegin
+	} else {
+		allocateFreePageCounter(p.store)
+		p.freeListHead = readFreeListHead(p.store)
+	}
+	p.truncateOnFlush = false
+	// Drain snapshot readers before the exclusive file lock is released since
+	// their snapshot is only stable while this process holds the lock.
+	p.beginFlush()
 	p.store.GetLock().Unlock()
+	p.snapshotMu.Unlock()
 }
 
 // GetPage returns an allocated page. GetPage will return cached pages. GetPage
 // will return dirtyPages during a write transaction.
 func (p *Pager) GetPage(pageNumber int) *Page {
+	return p.getPage(pageNumber, false)
+}
+
+// GetSnapshotPage returns an allocated page for a snapshot reader. Snapshot
+// readers never observe the dirty pages of an in flight write transaction.
+func (p *Pager) GetSnapshotPage(pageNumber int) *Page {
+	return p.getPage(pageNumber, true)
+}
+
+func (p *Pager) getPage(pageNumber int, snapshot bool) *Page {
 	// During a write pages are collected in the dirtyPages buffer. These pages
 	// must be retrieved from the buffer as they are modified because the file
-	// is becoming outdated.
-	if p.isWriting {
-		dpn := slices.IndexFunc(p.dirtyPages, func(dp *Page) bool {
-			return dp.number == pageNumber
-		})
-		if dpn != -1 {
-			return p.dirtyPages[dpn]
+	// is becoming outdated. The dirty pages are private to the writer so
+	// snapshot readers continue against the cache and storage.
+	if !snapshot && p.isWriting {
+		if dp, ok := p.dirtyPages[pageNumber]; ok {
+			return dp
 		}
-	} else {
-		if v, hit := p.pageCache.Get(pageNumber); hit {
+		// Pages spilled by the in flight transaction hold newer content than
+		// the committed frames and the database file.
+		if p.wal != nil {
+			if page, hit := p.wal.getSpilledPage(pageNumber); hit {
+				ap := p.allocatePage(pageNumber, page)
+				p.dirtyPages[pageNumber] = ap
+				return ap
+			}
+		}
+		// A page in the committed set must be copied since the set holds the
+		// durable image of the page until the background flush writes it.
+		if cp, hit := p.getAsyncCommittedPage(pageNumber); hit {
+			content := make([]byte, len(cp))
+			copy(content, cp)
+			ap := p.allocatePage(pageNumber, content)
+			p.dirtyPages[pageNumber] = ap
+			return ap
+		}
+		ap := p.allocatePage(pageNumber, p.readPage(pageNumber))
+		p.dirtyPages[pageNumber] = ap
+		return ap
+	}
+	// Pages committed in memory are newer than the page cache and the file
+	// until the background flush writes them.
+	if cp, hit := p.getAsyncCommittedPage(pageNumber); hit {
+		return p.allocatePage(pageNumber, cp)
+	}
+	// A memory mapped store hands out page slices backed by the OS page cache
+	// meaning the LRU cache and its copies are unnecessary. The fast path is
+	// skipped in write ahead log mode since the log can hold frames newer
+	// than the database file.
+	if sr, ok := p.store.(sliceReaderAt); ok && p.wal == nil {
+		off := int64(rootPageStart + (pageNumber-1)*p.pageSize)
+		// A page that has never been written has no type and would be stamped
+		// as a leaf by allocatePage. Stamping faults on the read only mapping
+		// so such a page falls through to be read as a copy.
+		if v, hit := sr.ReadSliceAt(off, p.pageSize); hit && v[pageTypeOffset] != pageTypeUnknown {
 			return p.allocatePage(pageNumber, v)
 		}
 	}
-	page := make([]byte, pageSize)
-	// Page number subtracted by 1 since 0 is reserved as a pointer to nothing.
-	p.store.ReadAt(page, int64(rootPageStart+(pageNumber-1)*pageSize))
-	ap := p.allocatePage(pageNumber, page)
-	if p.isWriting {
-		p.dirtyPages = append(p.dirtyPages, ap)
+	if v, hit := p.pageCache.Get(pageNumber); hit {
+		return p.allocatePage(pageNumber, v)
 	}
+	page := p.readPage(pageNumber)
+	ap := p.allocatePage(pageNumber, page)
 	p.pageCache.Add(pageNumber, page)
 	return ap
 }
 
+// getAsyncCommittedPage returns the content of the page from the committed
+// set or false when the page has no unflushed commit. Committed content is
+// never mutated in place so the content can be shared with readers.
+func (p *Pager) getAsyncCommittedPage(pageNumber int) ([]byte, bool) {
+	if p.asyncCommitted == nil {
+		return nil, false
+	}
+	p.asyncMu.Lock()
+	defer p.asyncMu.Unlock()
+	cp, ok := p.asyncCommitted[pageNumber]
+	if !ok {
+		return nil, false
+	}
+	return cp.content, true
+}
+
+// readPage reads the page content from the write ahead log or the database
+// file.
+func (p *Pager) readPage(pageNumber int) []byte {
+	// Pages with committed frames in the write ahead log are newer than the
+	// database file and must be read from the log.
+	if p.wal != nil {
+		if page, hit := p.wal.getPage(pageNumber); hit {
+			return page
+		}
+	}
+	page := make([]byte, p.pageSize)
+	// Page number subtracted by 1 since 0 is reserved as a pointer to nothing.
+	p.store.ReadAt(page, int64(rootPageStart+(pageNumber-1)*p.pageSize))
+	return page
+}
+
+// PrefetchScan hints that a sequential scan is about to read the right linked
+// chain starting at the given page. The hint is handed to a background
+// goroutine reading the chain into the page cache so a cold scan overlaps its
+// page reads with tuple processing instead of paying a read latency per page.
+// A hint arriving while a prefetch is in progress is coalesced into one
+// pending prefetch and is dropped when a pending hint exists. The hint is
+// also dropped when page reads are slices of a memory mapping since those are
+// already backed by the OS page cache.
+func (p *Pager) PrefetchScan(pageNumber int) {
+	if _, ok := p.store.(sliceReaderAt); ok && p.wal == nil {
+		return
+	}
+	select {
+	case p.prefetchCh <- pageNumber:
+	default:
+	}
+}
+
+// prefetchLoop runs in a background goroutine reading right linked pages into
+// the page cache ahead of scanning cursors.
+func (p *Pager) prefetchLoop() {
+	for pageNumber := range p.prefetchCh {
+		p.prefetch(pageNumber)
+	}
+}
+
+// prefetch follows the right pointer chain from the given page reading up to
+// prefetchDepth uncached pages into the page cache. Holding the snapshot read
+// side excludes the flush portion of a commit meaning the pages read are
+// committed content, the same visibility a snapshot reader has. A page that
+// has never been written reads as zeroes and ends the chain like any rightmost
+// page since its right pointer is empty.
+func (p *Pager) prefetch(pageNumber int) {
+	p.snapshotMu.RLock()
+	defer p.snapshotMu.RUnlock()
+	pn := pageNumber
+	for i := 0; i < prefetchDepth; i += 1 {
+		if pn == emptyParentPageNumber {
+			return
+		}
+		content, hit := p.pageCache.Peek(pn)
+		if !hit {
+			content = p.readPage(pn)
+			p.pageCache.Add(pn, content)
+		}
+		right := binary.LittleEndian.Uint32(content[rightPointerOffset : rightPointerOffset+pagePointerSize])
+		pn = int(right)
+	}
+}
+
 // writePage writes the page to storage.
 func (p *Pager) writePage(page *Page) error {
 	// Page number subtracted by one since 0 is reserved as a pointer to nothing
 	pn := page.GetNumber() - 1
-	pns := pn * pageSize
+	pns := pn * p.pageSize
 	off := rootPageStart + pns
 	_, err := p.store.WriteAt(page.content, int64(off))
 	return err
 }
 
-// NewPage increases the free page counter, allocates a new page, and adds it to
-// the dirtyPages list. NewPage must be called during a write transaction.
+// NewPage allocates a new page and adds it to the dirtyPages list. A page from
+// the free list is reused before the free page counter is increased meaning
+// freed pages are reclaimed before the file grows. NewPage must be called
+// during a write transaction.
 func (p *Pager) NewPage() *Page {
 	if !p.isWriting {
 		panic("must be a write transaction to allocate a new page")
 	}
-	p.currentMaxPage += 1
-	np := p.allocatePage(p.currentMaxPage, make([]byte, pageSize))
-	if p.isWriting {
-		p.dirtyPages = append(p.dirtyPages, np)
+	if p.freeListHead != emptyParentPageNumber {
+		fp := p.getPage(p.freeListHead, false)
+		_, next := fp.GetRightPageNumber()
+		p.freeListHead = next
+		copy(fp.content, make([]byte, len(fp.content)))
+		fp.SetType(pageTypeLeaf)
+		return fp
 	}
+	p.currentMaxPage += 1
+	np := p.allocatePage(p.currentMaxPage, make([]byte, p.pageSize))
+	p.dirtyPages[np.number] = np
 	return np
 }
 
+// FreePage returns the page to the free list so NewPage can reuse it. The
+// caller must guarantee nothing references the page. FreePage must be called
+// during a write transaction.
+func (p *Pager) FreePage(page *Page) {
+	if !p.isWriting {
+		panic("must be a write transaction to free a page")
+	}
+	copy(page.content, make([]byte, len(page.content)))
+	page.SetType(pageTypeFree)
+	page.SetRightPageNumber(p.freeListHead)
+	p.freeListHead = page.GetNumber()
+	p.dirtyPages[page.GetNumber()] = page
+}
+
+// Compact restarts page allocation from the first page so a following rewrite
+// of every B tree packs the file from the front. Pages read so far by the
+// write transaction are discarded along with the free list and the file is
+// truncated to the last allocated page when the transaction commits. Compact
+// must be called during a write transaction and the caller must rewrite every
+// live page before the transaction commits.
+func (p *Pager) Compact() {
+	if !p.isWriting {
+		panic("must be a write transaction to compact")
+	}
+	p.dirtyPages = map[int]*Page{}
+	if p.wal != nil {
+		p.wal.dropSpilled()
+	}
+	p.currentMaxPage = 1
+	p.freeListHead = emptyParentPageNumber
+	p.truncateOnFlush = true
+}
+
+// truncateTail truncates the file to the last allocated page after a
+// compaction. Storage that cannot truncate such as a memory mapped file keeps
+// its size and the tail is simply never read since page allocation is governed
+// by the free page counter.
+func (p *Pager) truncateTail() {
+	if !p.truncateOnFlush {
+		return
+	}
+	p.truncateOnFlush = false
+	if t, ok := p.store.(truncater); ok {
+		t.Truncate(int64(rootPageStart + p.currentMaxPage*p.pageSize))
+	}
+}
+
+// SpillDirtyPages bounds the memory held by a write transaction. When the
+// dirty set exceeds maxDirtyPages the pages are spilled to the write ahead log
+// as uncommitted frames and the page buffers are released. Callers must not
+// hold Page references across the call since spilled pages are reallocated
+// when they are next retrieved. In rollback journal mode the dirty set is kept
+// in memory since the journal does not preserve pre images.
+func (p *Pager) SpillDirtyPages() error {
+	if p.wal == nil || len(p.dirtyPages) <= maxDirtyPages {
+		return nil
+	}
+	if err := p.wal.spillPages(p.dirtyPages); err != nil {
+		return err
+	}
+	p.dirtyPages = map[int]*Page{}
+	return nil
+}
+
 // allocatePage is a helper function that is capable of converting the
 // underlying byte slice into a page structure.
 func (p *Pager) allocatePage(pageNumber int, content []byte) *Page {
@@ -360,10 +1094,10 @@ func (p *Pager) allocatePage(pageNumber int, content []byte) *Page {
 // |                  grows backwards <----------- Tuple 3 - Tuple 2 - Tuple 1 |
 // +---------------------------------------------------------------------------+
 //
-// TODO could implement overflow pages in case a tuple is larger than some
-// threshold (say half the Page). There would be another block that would
-// contain pointers to overflow pages or be empty. The overflow pages would
-// contain a pointer to the next overflow Page and content of the overflow.
+// Overflow pages reuse the header fields with different meanings. The right
+// pointer is the pointer to the next overflow Page in the chain and the tuple
+// count is the byte length of the content which starts where the tuple
+// offsets would.
 type Page struct {
 	content []byte
 	number  int
@@ -446,6 +1180,31 @@ func (p *Page) SetTypeInternal() {
 	p.SetType(pageTypeInternal)
 }
 
+func (p *Page) SetTypeLeaf() {
+	p.SetType(pageTypeLeaf)
+}
+
+// OverflowPageCapacity is the count of content bytes an overflow page can
+// hold after its header.
+func (p *Pager) OverflowPageCapacity() int {
+	return p.pageSize - pageRowOffsetsOffset
+}
+
+// SetOverflowContent makes the page an overflow page holding the given bytes.
+// The count of bytes must not exceed OverflowPageCapacity. The next page in
+// the chain is set with SetRightPageNumber.
+func (p *Page) SetOverflowContent(b []byte) {
+	p.SetType(pageTypeOverflow)
+	p.setRecordCount(len(b))
+	copy(p.content[pageRowOffsetsOffset:pageRowOffsetsOffset+len(b)], b)
+}
+
+// GetOverflowContent returns the content of an overflow page.
+func (p *Page) GetOverflowContent() []byte {
+	l := p.GetRecordCount()
+	return p.content[pageRowOffsetsOffset : pageRowOffsetsOffset+l]
+}
+
 // GetRecordCount returns the value of the counter that tells how many tuples
 // are currently stored on the page.
 func (p *Page) GetRecordCount() int {
@@ -487,15 +1246,77 @@ func (p *Page) CanInsertTuples(pageTuples []PageTuple) bool {
 		s += len(e.Key)
 		s += len(e.Value)
 	}
-	return pageSize >= s
+	return len(p.content) >= s
+}
+
+// CanAppendTuple returns true if the page can fit the new tuple. Unlike
+// CanInsertTuple this is computed from the offset array in constant time
+// instead of re-serializing the page entries.
+func (p *Page) CanAppendTuple(key, value []byte) bool {
+	freeStart := pageRowOffsetsOffset + p.GetRecordCount()*(pageRowOffsetSize+pageRowOffsetSize)
+	freeEnd := p.freeSpaceEnd()
+	need := pageRowOffsetSize + pageRowOffsetSize + len(key) + len(value)
+	return freeEnd-freeStart >= need
+}
+
+// AppendTuple writes the tuple after the last tuple on the page without
+// rewriting the existing tuples. The caller must guarantee the key is greater
+// than every key on the page and that the tuple fits by checking
+// CanAppendTuple. This supports bulk loading sorted data in constant time per
+// tuple.
+func (p *Page) AppendTuple(key, value []byte) {
+	count := p.GetRecordCount()
+	entryEnd := p.freeSpaceEnd()
+	shift := pageRowOffsetsOffset + count*(pageRowOffsetSize+pageRowOffsetSize)
+
+	// set key offset
+	keyOffset := entryEnd - len(key) - len(value)
+	byteKeyOffset := make([]byte, pageRowOffsetSize)
+	binary.LittleEndian.PutUint16(byteKeyOffset, uint16(keyOffset))
+	copy(p.content[shift:shift+pageRowOffsetSize], byteKeyOffset)
+
+	// set value offset
+	valueOffset := entryEnd - len(value)
+	byteValueOffset := make([]byte, pageRowOffsetSize)
+	binary.LittleEndian.PutUint16(byteValueOffset, uint16(valueOffset))
+	copy(p.content[shift+pageRowOffsetSize:shift+pageRowOffsetSize+pageRowOffsetSize], byteValueOffset)
+
+	// set key
+	copy(p.content[keyOffset:valueOffset], key)
+
+	// set value
+	copy(p.content[valueOffset:valueOffset+len(value)], value)
+
+	p.setRecordCount(count + 1)
+}
+
+// IsUnderfull returns true when the page uses less than a quarter of its
+// space. An underfull page is a candidate to be merged with a sibling.
+func (p *Page) IsUnderfull() bool {
+	used := pageRowOffsetsOffset +
+		p.GetRecordCount()*(pageRowOffsetSize+pageRowOffsetSize) +
+		(len(p.content) - p.freeSpaceEnd())
+	return used < len(p.content)/4
+}
+
+// freeSpaceEnd returns the offset where tuple content begins. Tuples grow
+// backward from the end of the page meaning free space ends at the key offset
+// of the last tuple or the end of the page when the page is empty.
+func (p *Page) freeSpaceEnd() int {
+	count := p.GetRecordCount()
+	if count == 0 {
+		return len(p.content)
+	}
+	shift := pageRowOffsetsOffset + (count-1)*(pageRowOffsetSize+pageRowOffsetSize)
+	return int(binary.LittleEndian.Uint16(p.content[shift : shift+pageRowOffsetSize]))
 }
 
 // SetEntries sets the page tuples in sorted order.
 func (p *Page) SetEntries(entries []PageTuple) {
-	copy(p.content[pageRowOffsetsOffset:pageSize], make([]byte, pageSize-pageRowOffsetsOffset))
+	copy(p.content[pageRowOffsetsOffset:], make([]byte, len(p.content)-pageRowOffsetsOffset))
 	sort.Slice(entries, func(a, b int) bool { return bytes.Compare(entries[a].Key, entries[b].Key) == -1 })
 	shift := pageRowOffsetsOffset
-	entryEnd := pageSize
+	entryEnd := len(p.content)
 	for _, entry := range entries {
 		startKeyOffset := shift
 		endKeyOffset := shift + pageRowOffsetSize
@@ -530,7 +1351,7 @@ func (p *Page) SetEntries(entries []PageTuple) {
 func (p *Page) GetEntries() []PageTuple {
 	entries := []PageTuple{}
 	recordCount := p.GetRecordCount()
-	entryEnd := pageSize
+	entryEnd := len(p.content)
 	for i := 0; i < recordCount; i += 1 {
 		startKeyOffset := pageRowOffsetsOffset + (i * (pageRowOffsetSize + pageRowOffsetSize))
 		endKeyOffset := pageRowOffsetsOffset + (i * (pageRowOffsetSize + pageRowOffsetSize)) + pageRowOffsetSize
@@ -554,10 +1375,53 @@ func (p *Page) GetEntries() []PageTuple {
 	return entries
 }
 
-// SetValue searches with GetValue and adds the value or overwrites the existing
-// value.
+// GetTuple returns the tuple at index i in the sorted tuple offset array. The
+// returned key and value are slices into the page buffer meaning no copying is
+// performed. The slices are only valid until the page is mutated. Paths that
+// mutate the page copy tuples out with GetEntries before rewriting the buffer.
+func (p *Page) GetTuple(i int) PageTuple {
+	shift := pageRowOffsetsOffset + (i * (pageRowOffsetSize + pageRowOffsetSize))
+	keyOffset := int(binary.LittleEndian.Uint16(p.content[shift : shift+pageRowOffsetSize]))
+	valueOffset := int(binary.LittleEndian.Uint16(p.content[shift+pageRowOffsetSize : shift+pageRowOffsetSize+pageRowOffsetSize]))
+	// Tuples are stored back to front so the end of tuple i is the key offset
+	// of tuple i-1. The first tuple ends at the end of the page.
+	entryEnd := len(p.content)
+	if i != 0 {
+		prevShift := shift - (pageRowOffsetSize + pageRowOffsetSize)
+		entryEnd = int(binary.LittleEndian.Uint16(p.content[prevShift : prevShift+pageRowOffsetSize]))
+	}
+	return PageTuple{
+		Key:   p.content[keyOffset:valueOffset],
+		Value: p.content[valueOffset:entryEnd],
+	}
+}
+
+// FindTupleIndex performs a binary search on the sorted tuple offset array. It
+// returns the index of the first tuple whose key is not less than the search
+// key and a flag indicating the tuple at the index is an exact match. When the
+// search key is greater than every key on the page the returned index is the
+// record count.
+func (p *Page) FindTupleIndex(key []byte) (index int, exactMatch bool) {
+	low := 0
+	high := p.GetRecordCount()
+	for low < high {
+		mid := (low + high) / 2
+		if bytes.Compare(p.GetTuple(mid).Key, key) == -1 {
+			low = mid + 1
+		} else {
+			high = mid
+		}
+	}
+	if low < p.GetRecordCount() && bytes.Equal(p.GetTuple(low).Key, key) {
+		return low, true
+	}
+	return low, false
+}
+
+// SetValue searches with FindTupleIndex and adds the value or overwrites the
+// existing value.
 func (p *Page) SetValue(key, value []byte) {
-	_, found := p.GetValue(key)
+	_, found := p.FindTupleIndex(key)
 	if found {
 		withoutFound := []PageTuple{}
 		e := p.GetEntries()
@@ -576,30 +1440,31 @@ func (p *Page) SetValue(key, value []byte) {
 // value was found. If the page is leaf an exact match must be made. If the page
 // is internal GetValue will search for the range the key falls in and return
 // the ranges value.
+//
+// GetValue performs a binary search on the tuple offset array meaning a lookup
+// touches a handful of tuples instead of deserializing the entire page. The
+// returned value is a slice into the page buffer and is only valid until the
+// page is mutated.
 func (p *Page) GetValue(key []byte) (value []byte, exists bool) {
-	e := p.GetEntries()
-	if p.GetType() == pageTypeLeaf {
-		for _, entry := range e {
-			c := bytes.Compare(entry.Key, key)
-			if c == 0 { // entryKey == searchKey
-				return entry.Value, true
-			}
-		}
+	recordCount := p.GetRecordCount()
+	if recordCount == 0 {
 		return []byte{}, false
 	}
-	var prevEntry *PageTuple = nil
-	for _, entry := range e {
-		c := bytes.Compare(entry.Key, key)
-		if c == 0 { // entryKey == searchKey
-			return entry.Value, true
-		}
-		if c == 1 { // searchKey < entryKey
-			return prevEntry.Value, true
+	i, exactMatch := p.FindTupleIndex(key)
+	if p.GetType() == pageTypeLeaf {
+		if !exactMatch {
+			return []byte{}, false
 		}
-		prevEntry = &entry
+		return p.GetTuple(i).Value, true
+	}
+	if exactMatch {
+		return p.GetTuple(i).Value, true
 	}
-	if prevEntry != nil {
-		return prevEntry.Value, true
+	// The search key falls in the range owned by the preceding page pointer.
+	// When the search key is less than every key on the page descend through
+	// the ascending page pointer.
+	if i == 0 {
+		return p.GetTuple(0).Value, true
 	}
-	return []byte{}, false
+	return p.GetTuple(i - 1).Value, true
 }
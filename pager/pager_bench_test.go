@@ -0,0 +1,56 @@
+package pager
+
+import (
+	"encoding/binary"
+	"fmt"
+	"testing"
+)
+
+// benchTuples builds a fixed ordered set of tuples sized like small table
+// rows so benchmark runs are comparable.
+func benchTuples(n int) []PageTuple {
+	tuples := make([]PageTuple, n)
+	for i := 0; i < n; i += 1 {
+		key := make([]byte, 4)
+		binary.BigEndian.PutUint32(key, uint32(i))
+		tuples[i] = PageTuple{
+			Key:   key,
+			Value: []byte(fmt.Sprintf("row value %04d", i)),
+		}
+	}
+	return tuples
+}
+
+func BenchmarkPageSetEntries(b *testing.B) {
+	pager, err := New(true, "")
+	if err != nil {
+		b.Fatal(err)
+	}
+	page := pager.GetPage(1)
+	page.SetTypeLeaf()
+	tuples := benchTuples(64)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		page.SetEntries(tuples)
+	}
+}
+
+func BenchmarkPageGetValue(b *testing.B) {
+	pager, err := New(true, "")
+	if err != nil {
+		b.Fatal(err)
+	}
+	page := pager.GetPage(1)
+	page.SetTypeLeaf()
+	tuples := benchTuples(64)
+	page.SetEntries(tuples)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		key := tuples[i%len(tuples)].Key
+		if _, exists := page.GetValue(key); !exists {
+			b.Fatalf("expected value for key %v", key)
+		}
+	}
+}
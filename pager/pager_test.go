@@ -3,7 +3,10 @@ package pager
 import (
 	"bytes"
 	"encoding/binary"
+	"errors"
+	"os"
 	"testing"
+	"time"
 )
 
 func TestPageHelpers(t *testing.T) {
@@ -156,6 +159,54 @@ func TestGet(t *testing.T) {
 		}
 	})
 
+	t.Run("get internal range", func(t *testing.T) {
+		pager, err := New(true, "")
+		if err != nil {
+			t.Fatal(err)
+		}
+		p := pager.GetPage(1)
+		p.SetType(pageTypeInternal)
+		p.SetValue([]byte{2}, []byte{'l', 'o', 'w'})
+		p.SetValue([]byte{5}, []byte{'m', 'i', 'd'})
+		p.SetValue([]byte{8}, []byte{'t', 'o', 'p'})
+
+		// An exact match returns the matched range.
+		ret, found := p.GetValue([]byte{5})
+		if !found {
+			t.Error("expected found")
+		}
+		if !bytes.Equal(ret, []byte{'m', 'i', 'd'}) {
+			t.Errorf("expected mid got %v", ret)
+		}
+
+		// A key between ranges returns the preceding range.
+		ret, found = p.GetValue([]byte{6})
+		if !found {
+			t.Error("expected found")
+		}
+		if !bytes.Equal(ret, []byte{'m', 'i', 'd'}) {
+			t.Errorf("expected mid got %v", ret)
+		}
+
+		// A key above every range returns the last range.
+		ret, found = p.GetValue([]byte{9})
+		if !found {
+			t.Error("expected found")
+		}
+		if !bytes.Equal(ret, []byte{'t', 'o', 'p'}) {
+			t.Errorf("expected top got %v", ret)
+		}
+
+		// A key below every range returns the ascending range.
+		ret, found = p.GetValue([]byte{1})
+		if !found {
+			t.Error("expected found")
+		}
+		if !bytes.Equal(ret, []byte{'l', 'o', 'w'}) {
+			t.Errorf("expected low got %v", ret)
+		}
+	})
+
 	t.Run("get not found", func(t *testing.T) {
 		pager, err := New(true, "")
 		if err != nil {
@@ -171,6 +222,59 @@ func TestGet(t *testing.T) {
 	})
 }
 
+func TestSnapshotRead(t *testing.T) {
+	pager, err := New(true, "")
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	// Commit an initial value.
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	pager.GetPage(1).SetValue([]byte{1}, []byte{'o', 'l', 'd'})
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	// A writer mutates its private dirty page set.
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	pager.GetPage(1).SetValue([]byte{1}, []byte{'n', 'e', 'w'})
+
+	// A snapshot reader proceeds without waiting on the writer and sees the
+	// pre commit value.
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found := pager.GetSnapshotPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected found")
+	}
+	if !bytes.Equal(ret, []byte{'o', 'l', 'd'}) {
+		t.Errorf("expected old got %v", ret)
+	}
+	pager.EndRead()
+
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	// After the commit readers see the new value.
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found = pager.GetSnapshotPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected found")
+	}
+	if !bytes.Equal(ret, []byte{'n', 'e', 'w'}) {
+		t.Errorf("expected new got %v", ret)
+	}
+	pager.EndRead()
+}
+
 func ExpectUint16(t *testing.T, content []byte, start int, expected uint16) {
 	e := make([]byte, 2)
 	binary.LittleEndian.PutUint16(e, expected)
@@ -185,3 +289,223 @@ func ExpectByteArray(t *testing.T, content []byte, start int, expeted []byte) {
 		t.Errorf("expected %v got %v at range start %d end %d", expeted, content[start:end], start, end)
 	}
 }
+
+func TestPageSize(t *testing.T) {
+	t.Run("stamped at creation and read on reopen", func(t *testing.T) {
+		err := os.Remove("page_size_test.db")
+		if err != nil && !errors.Is(err, os.ErrNotExist) {
+			t.Fatal("could not remove existing page_size_test.db file")
+		}
+		pager, err := New(false, "page_size_test", WithPageSize(8192))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if res := pager.PageSize(); res != 8192 {
+			t.Fatalf("want page size 8192 got %d", res)
+		}
+		if err := pager.BeginWrite(); err != nil {
+			t.Fatal(err)
+		}
+		p := pager.GetPage(1)
+		p.SetValue([]byte{1}, []byte{'c', 'a', 'r', 'l'})
+		if err := pager.EndWrite(); err != nil {
+			t.Fatal(err)
+		}
+
+		// Reopening without the option keeps the stamped size since the page
+		// layout of existing pages depends on it.
+		reopened, err := New(false, "page_size_test")
+		if err != nil {
+			t.Fatal(err)
+		}
+		if res := reopened.PageSize(); res != 8192 {
+			t.Errorf("want page size 8192 after reopen got %d", res)
+		}
+		if err := reopened.BeginRead(); err != nil {
+			t.Fatal(err)
+		}
+		ret, found := reopened.GetPage(1).GetValue([]byte{1})
+		if !found {
+			t.Fatal("expected found")
+		}
+		if !bytes.Equal(ret, []byte{'c', 'a', 'r', 'l'}) {
+			t.Errorf("expected carl got %v", ret)
+		}
+		reopened.EndRead()
+		if err := os.Remove("page_size_test.db"); err != nil {
+			t.Fatal("failed to clean up page_size_test.db file")
+		}
+	})
+
+	t.Run("rejects invalid size", func(t *testing.T) {
+		if _, err := New(true, "", WithPageSize(1000)); err == nil {
+			t.Error("want error for page size that is not a power of two")
+		}
+		if _, err := New(true, "", WithPageSize(256)); err == nil {
+			t.Error("want error for page size below the minimum")
+		}
+	})
+}
+
+func TestAsyncCommit(t *testing.T) {
+	pager, err := New(true, "", WithAsyncCommit())
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	// Committed transactions are readable before the background flush makes
+	// them durable.
+	for i := 1; i <= 3; i += 1 {
+		if err := pager.BeginWrite(); err != nil {
+			t.Fatal(err)
+		}
+		pager.GetPage(1).SetValue([]byte{byte(i)}, []byte{'v', byte(i)})
+		if err := pager.EndWrite(); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	for i := 1; i <= 3; i += 1 {
+		ret, found := pager.GetPage(1).GetValue([]byte{byte(i)})
+		if !found {
+			t.Fatalf("expected key %d found before flush", i)
+		}
+		if !bytes.Equal(ret, []byte{'v', byte(i)}) {
+			t.Errorf("expected value for key %d got %v", i, ret)
+		}
+	}
+	pager.EndRead()
+
+	// A rollback does not disturb the committed but unflushed state.
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	pager.GetPage(1).SetValue([]byte{1}, []byte{'b', 'a', 'd'})
+	pager.RollbackWrite()
+
+	// After Flush the committed set is drained into storage and reads keep
+	// returning the committed values.
+	if err := pager.Flush(); err != nil {
+		t.Fatal(err)
+	}
+	pager.asyncMu.Lock()
+	remaining := len(pager.asyncCommitted)
+	pager.asyncMu.Unlock()
+	if remaining != 0 {
+		t.Errorf("expected empty committed set after flush got %d pages", remaining)
+	}
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found := pager.GetPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected key 1 found after flush")
+	}
+	if !bytes.Equal(ret, []byte{'v', 1}) {
+		t.Errorf("expected flushed value got %v", ret)
+	}
+	pager.EndRead()
+}
+
+func TestFreeList(t *testing.T) {
+	pager, err := New(true, "")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	a := pager.NewPage()
+	b := pager.NewPage()
+	pager.FreePage(a)
+	pager.FreePage(b)
+	// Freed pages are reused most recently freed first before the file grows.
+	if reused := pager.NewPage(); reused.GetNumber() != b.GetNumber() {
+		t.Errorf("want reused page %d got %d", b.GetNumber(), reused.GetNumber())
+	}
+	if reused := pager.NewPage(); reused.GetNumber() != a.GetNumber() {
+		t.Errorf("want reused page %d got %d", a.GetNumber(), reused.GetNumber())
+	}
+	grown := pager.NewPage()
+	if grown.GetNumber() != b.GetNumber()+1 {
+		t.Errorf("want grown page %d got %d", b.GetNumber()+1, grown.GetNumber())
+	}
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+}
+
+func TestPrefetch(t *testing.T) {
+	err := os.Remove("prefetch_test.db")
+	if err != nil && !errors.Is(err, os.ErrNotExist) {
+		t.Fatal("could not remove existing prefetch_test.db file")
+	}
+	pager, err := New(false, "prefetch_test")
+	if err != nil {
+		t.Fatal(err)
+	}
+	// Build a right linked chain 1 -> 2 -> 3 -> 4 like a leaf chain.
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	previous := pager.GetPage(1)
+	for i := 0; i < 3; i += 1 {
+		next := pager.NewPage()
+		previous.SetRightPageNumber(next.GetNumber())
+		previous = next
+	}
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	t.Run("reads the chain into the cache", func(t *testing.T) {
+		// Reopening gives a cold cache like a fresh process scanning a table.
+		reopened, err := New(false, "prefetch_test")
+		if err != nil {
+			t.Fatal(err)
+		}
+		hitsBefore, missesBefore := reopened.CacheStats()
+		reopened.prefetch(1)
+		if hits, misses := reopened.CacheStats(); hits != hitsBefore || misses != missesBefore {
+			t.Errorf("expected prefetch to leave cache stats unchanged")
+		}
+		if err := reopened.BeginRead(); err != nil {
+			t.Fatal(err)
+		}
+		for pn := 1; pn <= 4; pn += 1 {
+			reopened.GetPage(pn)
+		}
+		reopened.EndRead()
+		hits, misses := reopened.CacheStats()
+		if res := hits - hitsBefore; res != 4 {
+			t.Errorf("want 4 cache hits after prefetch got %d", res)
+		}
+		if res := misses - missesBefore; res != 0 {
+			t.Errorf("want 0 cache misses after prefetch got %d", res)
+		}
+	})
+
+	t.Run("hint prefetches in the background", func(t *testing.T) {
+		reopened, err := New(false, "prefetch_test")
+		if err != nil {
+			t.Fatal(err)
+		}
+		reopened.PrefetchScan(1)
+		deadline := time.Now().Add(2 * time.Second)
+		for {
+			if _, hit := reopened.pageCache.Peek(4); hit {
+				break
+			}
+			if time.Now().After(deadline) {
+				t.Fatal("expected page 4 to be prefetched")
+			}
+			time.Sleep(time.Millisecond)
+		}
+	})
+
+	if err := os.Remove("prefetch_test.db"); err != nil {
+		t.Fatal("failed to clean up prefetch_test.db file")
+	}
+}
@@ -18,6 +18,18 @@ type storage interface {
 	GetLock() lock
 }
 
+// sliceReaderAt is implemented by storage capable of returning a slice of its
+// contents without copying for example a memory mapped file.
+type sliceReaderAt interface {
+	ReadSliceAt(off int64, n int) ([]byte, bool)
+}
+
+// truncater is implemented by storage capable of shrinking to the given size
+// so a compaction can shrink the database file.
+type truncater interface {
+	Truncate(size int64) error
+}
+
 type memoryStorage struct {
 	buf  []byte
 	lock lock
@@ -25,7 +37,7 @@ type memoryStorage struct {
 
 func newMemoryStorage() storage {
 	return &memoryStorage{
-		buf: make([]byte, pageSize),
+		buf: make([]byte, defaultPageSize),
 		lock: &memoryLock{
 			l: &sync.RWMutex{},
 		},
@@ -34,7 +46,7 @@ func newMemoryStorage() storage {
 
 func (mf *memoryStorage) WriteAt(p []byte, off int64) (n int, err error) {
 	for len(mf.buf) < int(off)+len(p) {
-		mf.buf = append(mf.buf, make([]byte, pageSize)...)
+		mf.buf = append(mf.buf, make([]byte, defaultPageSize)...)
 	}
 	copy(mf.buf[off:len(p)+int(off)], p)
 	return 0, nil
@@ -42,7 +54,7 @@ func (mf *memoryStorage) WriteAt(p []byte, off int64) (n int, err error) {
 
 func (mf *memoryStorage) ReadAt(p []byte, off int64) (n int, err error) {
 	for len(mf.buf) < int(off)+len(p) {
-		mf.buf = append(mf.buf, make([]byte, pageSize)...)
+		mf.buf = append(mf.buf, make([]byte, defaultPageSize)...)
 	}
 	copy(p, mf.buf[off:len(p)+int(off)])
 	return 0, nil
@@ -58,6 +70,13 @@ func (mf *memoryStorage) DeleteJournal() error {
 	return nil
 }
 
+func (mf *memoryStorage) Truncate(size int64) error {
+	if int64(len(mf.buf)) > size {
+		mf.buf = mf.buf[:size]
+	}
+	return nil
+}
+
 func (ms *memoryStorage) GetLock() lock {
 	return ms.lock
 }
@@ -152,3 +171,7 @@ func (s *fileStorage) DeleteJournal() error {
 func (s *fileStorage) GetLock() lock {
 	return s.lock
 }
+
+func (s *fileStorage) Truncate(size int64) error {
+	return s.file.Truncate(size)
+}
@@ -0,0 +1,284 @@
+package pager
+
+// wal implements a write ahead log journaling mode. Instead of flushing dirty
+// pages into the database file on every commit, commits append the dirty pages
+// to the log. The log is periodically checkpointed back into the database file.
+// This makes the cost of a commit proportional to the count of dirty pages
+// instead of the size of the database file and leaves the database file
+// readable while a commit is in flight.
+
+import (
+	"encoding/binary"
+	"fmt"
+	"io"
+	"os"
+)
+
+// WAL constants
+const (
+	// walSuffix is the suffix of the filename the write ahead log uses. If the
+	// database file is called cdb.db the log will be called cdb-wal.db.
+	walSuffix = "-wal"
+	// walFrameCountOffset is in the first position of the log header. It
+	// stores the count of committed frames. Updating the counter is the atomic
+	// commit point. Frames beyond the counter belong to an incomplete commit
+	// and are discarded during recovery.
+	walFrameCountOffset = 0
+	// walFrameCountSize is a uint32.
+	walFrameCountSize = 4
+	// walFreePageCounterOffset stores the free page counter as of the last
+	// committed frame so the counter survives a crash before a checkpoint.
+	walFreePageCounterOffset = walFrameCountOffset + walFrameCountSize
+	// walHeaderSize marks the end of the log header and the start of frames.
+	walHeaderSize = walFreePageCounterOffset + freePageCounterSize
+	// walCheckpointThreshold is the count of frames that triggers a checkpoint
+	// at the end of a commit.
+	walCheckpointThreshold = 1000
+)
+
+// walStore is the storage for the log. It is implemented by os.File and by an
+// in memory representation for testing purposes.
+type walStore interface {
+	io.ReaderAt
+	io.WriterAt
+	Truncate(size int64) error
+}
+
+// memoryWalStore implements walStore without a file.
+type memoryWalStore struct {
+	buf []byte
+}
+
+func (m *memoryWalStore) WriteAt(p []byte, off int64) (n int, err error) {
+	for len(m.buf) < int(off)+len(p) {
+		m.buf = append(m.buf, make([]byte, defaultPageSize)...)
+	}
+	copy(m.buf[off:len(p)+int(off)], p)
+	return len(p), nil
+}
+
+func (m *memoryWalStore) ReadAt(p []byte, off int64) (n int, err error) {
+	for len(m.buf) < int(off)+len(p) {
+		m.buf = append(m.buf, make([]byte, defaultPageSize)...)
+	}
+	copy(p, m.buf[off:len(p)+int(off)])
+	return len(p), nil
+}
+
+func (m *memoryWalStore) Truncate(size int64) error {
+	m.buf = m.buf[:size]
+	return nil
+}
+
+// getWalName returns the name of the log file for the given database filename.
+func getWalName(filename string) string {
+	if filename == "" {
+		return fmt.Sprintf("%s%s.db", DefaultDBFileName, walSuffix)
+	}
+	return fmt.Sprintf("%s%s.db", filename, walSuffix)
+}
+
+// wal is an append only log of committed pages.
+type wal struct {
+	store walStore
+	// frames maps a page number to the offset of the latest committed frame
+	// holding that page. Pages present in the map must be read from the log
+	// since the database file is out of date for them.
+	frames map[int]int64
+	// frameCount is the count of committed frames in the log.
+	frameCount int
+	// freePageCounter is the free page counter as of the last commit.
+	freePageCounter int
+	// spilled maps a page number to the offset of an uncommitted spilled
+	// frame. Spilled frames sit after the committed frames and belong to the
+	// in flight write transaction. They only become visible to readers once a
+	// commit moves them into the frame index.
+	spilled map[int]int64
+	// spilledCount is the count of uncommitted spilled frames.
+	spilledCount int
+	// pageSize is the byte size of a single page matching the page size of
+	// the database file.
+	pageSize int
+	// frameSize is the size of a single frame being the page number followed
+	// by the page content.
+	frameSize int
+}
+
+// newWal opens the log and rebuilds the frame index from the committed frames.
+func newWal(store walStore, pageSize int) (*wal, error) {
+	w := &wal{
+		store:     store,
+		frames:    map[int]int64{},
+		spilled:   map[int]int64{},
+		pageSize:  pageSize,
+		frameSize: pagePointerSize + pageSize,
+	}
+	b := make([]byte, walHeaderSize)
+	if _, err := store.ReadAt(b, 0); err != nil && err != io.EOF {
+		return nil, fmt.Errorf("error reading wal header: %w", err)
+	}
+	w.frameCount = int(binary.LittleEndian.Uint32(b[walFrameCountOffset : walFrameCountOffset+walFrameCountSize]))
+	w.freePageCounter = int(binary.LittleEndian.Uint32(b[walFreePageCounterOffset : walFreePageCounterOffset+freePageCounterSize]))
+	for i := 0; i < w.frameCount; i += 1 {
+		offset := int64(walHeaderSize + i*w.frameSize)
+		pnb := make([]byte, pagePointerSize)
+		if _, err := w.store.ReadAt(pnb, offset); err != nil {
+			return nil, fmt.Errorf("error reading wal frame: %w", err)
+		}
+		pn := int(binary.LittleEndian.Uint32(pnb))
+		w.frames[pn] = offset + pagePointerSize
+	}
+	return w, nil
+}
+
+// appendPages commits the given pages along with any spilled frames by
+// appending a frame for each page and then updating the committed frame
+// counter.
+func (w *wal) appendPages(pages map[int]*Page, freePageCounter int) error {
+	count := w.frameCount + w.spilledCount
+	written := map[int]int64{}
+	for _, p := range pages {
+		offset := int64(walHeaderSize + count*w.frameSize)
+		if err := w.writeFrame(p, offset); err != nil {
+			return err
+		}
+		written[p.GetNumber()] = offset + pagePointerSize
+		count += 1
+	}
+	b := make([]byte, walHeaderSize)
+	binary.LittleEndian.PutUint32(b[walFrameCountOffset:], uint32(count))
+	binary.LittleEndian.PutUint32(b[walFreePageCounterOffset:], uint32(freePageCounter))
+	if _, err := w.store.WriteAt(b, 0); err != nil {
+		return fmt.Errorf("error writing wal header: %w", err)
+	}
+	// The index is only updated after the commit point so a failed commit
+	// leaves the index pointing at the previously committed frames. Spilled
+	// frames are moved in first so a page that was spilled and dirtied again
+	// resolves to its latest frame.
+	for pn, offset := range w.spilled {
+		w.frames[pn] = offset
+	}
+	for pn, offset := range written {
+		w.frames[pn] = offset
+	}
+	w.frameCount = count
+	w.freePageCounter = freePageCounter
+	w.spilled = map[int]int64{}
+	w.spilledCount = 0
+	return nil
+}
+
+// writeFrame writes a single frame for the page at the given offset.
+func (w *wal) writeFrame(p *Page, offset int64) error {
+	pnb := make([]byte, pagePointerSize)
+	binary.LittleEndian.PutUint32(pnb, uint32(p.GetNumber()))
+	if _, err := w.store.WriteAt(pnb, offset); err != nil {
+		return fmt.Errorf("error writing wal frame header: %w", err)
+	}
+	if _, err := w.store.WriteAt(p.content, offset+pagePointerSize); err != nil {
+		return fmt.Errorf("error writing wal frame: %w", err)
+	}
+	return nil
+}
+
+// spillPages appends the pages as uncommitted frames so the write transaction
+// can release the page buffers before it commits. A crash or rollback leaves
+// the committed frame counter untouched meaning the spilled frames are simply
+// overwritten by the next transaction.
+func (w *wal) spillPages(pages map[int]*Page) error {
+	for _, p := range pages {
+		offset := int64(walHeaderSize + (w.frameCount+w.spilledCount)*w.frameSize)
+		if err := w.writeFrame(p, offset); err != nil {
+			return err
+		}
+		w.spilled[p.GetNumber()] = offset + pagePointerSize
+		w.spilledCount += 1
+	}
+	return nil
+}
+
+// getSpilledPage returns the content of an uncommitted spilled frame for the
+// page and a flag indicating the page has a spilled frame.
+func (w *wal) getSpilledPage(pageNumber int) ([]byte, bool) {
+	offset, ok := w.spilled[pageNumber]
+	if !ok {
+		return nil, false
+	}
+	b := make([]byte, w.pageSize)
+	if _, err := w.store.ReadAt(b, offset); err != nil {
+		return nil, false
+	}
+	return b, true
+}
+
+// dropFramesAbove removes frames for pages beyond the given page number from
+// the frame index after a compaction. The frames stay in the log until the
+// next checkpoint truncates it but are never read or checkpointed.
+func (w *wal) dropFramesAbove(maxPage int) {
+	for pn := range w.frames {
+		if pn > maxPage {
+			delete(w.frames, pn)
+		}
+	}
+}
+
+// dropSpilled discards the uncommitted spilled frames during a rollback.
+func (w *wal) dropSpilled() {
+	w.spilled = map[int]int64{}
+	w.spilledCount = 0
+}
+
+// getPage returns the latest committed content of the page and a flag
+// indicating the page is present in the log. Pages not present must be read
+// from the database file.
+func (w *wal) getPage(pageNumber int) ([]byte, bool) {
+	offset, ok := w.frames[pageNumber]
+	if !ok {
+		return nil, false
+	}
+	b := make([]byte, w.pageSize)
+	if _, err := w.store.ReadAt(b, offset); err != nil {
+		return nil, false
+	}
+	return b, true
+}
+
+// checkpoint writes the latest committed version of each logged page into the
+// database file and truncates the log.
+func (w *wal) checkpoint(s storage) error {
+	for pageNumber, offset := range w.frames {
+		b := make([]byte, w.pageSize)
+		if _, err := w.store.ReadAt(b, offset); err != nil {
+			return fmt.Errorf("error reading wal frame for checkpoint: %w", err)
+		}
+		if _, err := s.WriteAt(b, int64(rootPageStart+(pageNumber-1)*w.pageSize)); err != nil {
+			return fmt.Errorf("error checkpointing page %d: %w", pageNumber, err)
+		}
+	}
+	if w.freePageCounter != 0 {
+		fb := make([]byte, freePageCounterSize)
+		binary.LittleEndian.PutUint32(fb, uint32(w.freePageCounter))
+		if _, err := s.WriteAt(fb, freePageCounterOffset); err != nil {
+			return fmt.Errorf("error checkpointing free page counter: %w", err)
+		}
+	}
+	if err := w.store.Truncate(0); err != nil {
+		return fmt.Errorf("error truncating wal: %w", err)
+	}
+	w.frames = map[int]int64{}
+	w.frameCount = 0
+	return nil
+}
+
+// newWalStore opens the log storage for the given database filename. The
+// useMemory flag mirrors the pager's in memory mode.
+func newWalStore(useMemory bool, filename string) (walStore, error) {
+	if useMemory {
+		return &memoryWalStore{}, nil
+	}
+	f, err := os.OpenFile(getWalName(filename), os.O_RDWR|os.O_CREATE, 0644)
+	if err != nil {
+		return nil, fmt.Errorf("error opening wal file: %w", err)
+	}
+	return f, nil
+}
@@ -0,0 +1,90 @@
+package pager
+
+import (
+	"bytes"
+	"errors"
+	"os"
+	"testing"
+)
+
+func TestWalCommitAndRead(t *testing.T) {
+	pager, err := New(true, "", WithJournalMode(JournalModeWal))
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	p := pager.GetPage(1)
+	p.SetValue([]byte{1}, []byte{'c', 'a', 'r', 'l'})
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	if pager.wal.frameCount != 1 {
+		t.Fatalf("expected 1 committed frame got %d", pager.wal.frameCount)
+	}
+
+	if err := pager.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found := pager.GetPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected found")
+	}
+	if !bytes.Equal(ret, []byte{'c', 'a', 'r', 'l'}) {
+		t.Errorf("expected carl got %v", ret)
+	}
+	pager.EndRead()
+}
+
+func TestWalRecovery(t *testing.T) {
+	for _, f := range []string{"wal_test.db", "wal_test-wal.db"} {
+		err := os.Remove(f)
+		if err != nil && !errors.Is(err, os.ErrNotExist) {
+			t.Fatalf("could not remove existing %s file", f)
+		}
+	}
+
+	pager, err := New(false, "wal_test", WithJournalMode(JournalModeWal))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := pager.BeginWrite(); err != nil {
+		t.Fatal(err)
+	}
+	p := pager.GetPage(1)
+	p.SetValue([]byte{1}, []byte{'j', 'i', 'l', 'l'})
+	if err := pager.EndWrite(); err != nil {
+		t.Fatal(err)
+	}
+
+	// The commit lives in the log and has not been checkpointed into the
+	// database file. Opening a second pager checkpoints the committed frames
+	// so the data must be visible.
+	pager2, err := New(false, "wal_test", WithJournalMode(JournalModeWal))
+	if err != nil {
+		t.Fatal(err)
+	}
+	if pager2.wal.frameCount != 0 {
+		t.Fatalf("expected recovery to checkpoint the log got %d frames", pager2.wal.frameCount)
+	}
+	if err := pager2.BeginRead(); err != nil {
+		t.Fatal(err)
+	}
+	ret, found := pager2.GetPage(1).GetValue([]byte{1})
+	if !found {
+		t.Fatal("expected found")
+	}
+	if !bytes.Equal(ret, []byte{'j', 'i', 'l', 'l'}) {
+		t.Errorf("expected jill got %v", ret)
+	}
+	pager2.EndRead()
+
+	for _, f := range []string{"wal_test.db", "wal_test-wal.db"} {
+		if err := os.Remove(f); err != nil {
+			t.Fatalf("failed to clean up %s file", f)
+		}
+	}
+}
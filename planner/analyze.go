@@ -0,0 +1,62 @@
+package planner
+
+import (
+	"github.com/chirst/cdb/compiler"
+	"github.com/chirst/cdb/vm"
+)
+
+// analyzeCatalog defines the catalog methods needed by the analyze planner.
+type analyzeCatalog interface {
+	GetVersion() string
+}
+
+// analyzePlanner generates plans for the ANALYZE statement. The plan gathers
+// statistics for every table inside a write transaction and reparses the
+// schema since the statistics are persisted as schema objects.
+type analyzePlanner struct {
+	// stmt contains the AST.
+	stmt *compiler.AnalyzeStmt
+	// queryPlan contains the plan being built.
+	queryPlan *QueryPlan
+	// executionPlan contains the execution plan for the vm. This is built by
+	// calling ExecutionPlan.
+	executionPlan *vm.ExecutionPlan
+}
+
+// NewAnalyze returns an instance of an analyze planner for the given
+// statement.
+func NewAnalyze(catalog analyzeCatalog, stmt *compiler.AnalyzeStmt) *analyzePlanner {
+	return &analyzePlanner{
+		stmt: stmt,
+		executionPlan: vm.NewExecutionPlan(
+			catalog.GetVersion(),
+			stmt.Explain,
+			stmt.ExplainAnalyze,
+		),
+	}
+}
+
+// QueryPlan generates the query plan tree for the planner.
+func (p *analyzePlanner) QueryPlan() (*QueryPlan, error) {
+	an := &analyzeNode{}
+	plan := newQueryPlan(an, p.stmt.ExplainQueryPlan, transactionTypeWrite)
+	an.plan = plan
+	p.queryPlan = plan
+	return plan, nil
+}
+
+// ExecutionPlan returns the bytecode execution plan for the planner. Calling
+// QueryPlan is not a prerequisite to this method as it will be called by
+// ExecutionPlan if needed.
+func (p *analyzePlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
+	if p.queryPlan == nil {
+		_, err := p.QueryPlan()
+		if err != nil {
+			return nil, err
+		}
+	}
+	p.queryPlan.compile()
+	p.executionPlan.Commands = p.queryPlan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.freeRegister
+	return p.executionPlan, nil
+}
@@ -39,6 +39,7 @@ func NewCreate(catalog createCatalog, stmt *compiler.CreateStmt) *createPlanner
 		executionPlan: vm.NewExecutionPlan(
 			catalog.GetVersion(),
 			stmt.Explain,
+			stmt.ExplainAnalyze,
 		),
 	}
 }
@@ -161,5 +162,6 @@ func (p *createPlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
 	}
 	p.queryPlan.plan.compile()
 	p.executionPlan.Commands = p.queryPlan.plan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.plan.freeRegister
 	return p.executionPlan, nil
 }
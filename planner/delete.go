@@ -12,6 +12,7 @@ type deleteCatalog interface {
 	GetColumns(string) ([]string, error)
 	GetPrimaryKeyColumn(string) (string, error)
 	GetColumnType(tableName string, columnName string) (catalog.CdbType, error)
+	GetStats(tableName string) (*catalog.TableStats, bool)
 }
 
 type deletePlanner struct {
@@ -28,6 +29,7 @@ func NewDelete(catalog deleteCatalog, stmt *compiler.DeleteStmt) *deletePlanner
 		executionPlan: vm.NewExecutionPlan(
 			catalog.GetVersion(),
 			stmt.Explain,
+			stmt.ExplainAnalyze,
 		),
 	}
 }
@@ -69,7 +71,7 @@ func (d *deletePlanner) QueryPlan() (*QueryPlan, error) {
 		deleteNode.child = sn
 		sn.parent = deleteNode
 	}
-	(&optimizer{}).optimizePlan(qp)
+	(&optimizer{catalog: d.catalog}).optimizePlan(qp)
 	return qp, nil
 }
 
@@ -83,5 +85,7 @@ func (d *deletePlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
 	}
 	d.queryPlan.plan.compile()
 	d.executionPlan.Commands = d.queryPlan.plan.commands
+	d.executionPlan.MaxRegister = d.queryPlan.plan.freeRegister
+	d.executionPlan.NumParams = d.queryPlan.plan.parameterCount()
 	return d.executionPlan, nil
 }
@@ -43,6 +43,10 @@ func (mockDeleteCatalog) GetColumnType(tableName string, columnName string) (cat
 	return catalog.CdbType{ID: catalog.CTInt}, nil
 }
 
+func (*mockDeleteCatalog) GetStats(tableName string) (*catalog.TableStats, bool) {
+	return nil, false
+}
+
 func TestDelete(t *testing.T) {
 	type deleteTestCase struct {
 		expectation      string
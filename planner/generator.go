@@ -138,6 +138,11 @@ func (c *createNode) consume() {
 	if c.noop {
 		return
 	}
+	// The create routine uses fixed registers 1 through 8. The free register
+	// counter is bumped past them so the recorded max register covers them.
+	if c.plan.freeRegister < 9 {
+		c.plan.freeRegister = 9
+	}
 	c.plan.commands = append(
 		c.plan.commands,
 		&vm.OpenWriteCmd{P1: c.catalogCursorId, P2: c.catalogRootPageNumber},
@@ -163,6 +168,10 @@ func (n *insertNode) consume() {
 		n.plan.commands,
 		&vm.OpenWriteCmd{P1: n.cursorId, P2: n.rootPageNumber},
 	)
+	if len(n.colValues) > 1 {
+		n.consumeBatch()
+		return
+	}
 	for valuesIdx := range len(n.colValues) {
 		// Setup rowid and it's uniqueness/type checks
 		pkRegister := n.plan.freeRegister
@@ -216,6 +225,71 @@ func (n *insertNode) consume() {
 	}
 }
 
+// consumeBatch lowers a multi row insert into a single BatchInsertCmd so the
+// kv layer places all rows with one tree descent per target leaf instead of
+// one per row. The key and record for every row are staged in two contiguous
+// register blocks first.
+func (n *insertNode) consumeBatch() {
+	rows := len(n.colValues)
+	keyStart := n.plan.freeRegister
+	n.plan.freeRegister += rows
+	for valuesIdx := 0; valuesIdx < rows; valuesIdx += 1 {
+		pkRegister := keyStart + valuesIdx
+		if n.autoPk {
+			n.plan.commands = append(n.plan.commands, &vm.NewRowIdCmd{
+				P1: n.cursorId,
+				P2: pkRegister,
+			})
+		} else {
+			generateExpressionTo(n.plan, n.pkValues[valuesIdx], pkRegister, n.cursorId)
+			n.plan.commands = append(n.plan.commands, &vm.MustBeIntCmd{P1: pkRegister})
+			nec := &vm.NotExistsCmd{
+				P1: n.cursorId,
+				P3: pkRegister,
+			}
+			n.plan.commands = append(n.plan.commands, nec)
+			n.plan.commands = append(n.plan.commands, &vm.HaltCmd{
+				P1: 1,
+				P4: pkConstraint,
+			})
+			nec.P2 = len(n.plan.commands)
+		}
+	}
+	recordStart := n.plan.freeRegister
+	n.plan.freeRegister += rows
+	// The value expressions of every row land in one scratch block reused
+	// between rows since each MakeRecordCmd copies them out into its record.
+	scratchStart := n.plan.freeRegister
+	scratchLen := 0
+	for valuesIdx := 0; valuesIdx < rows; valuesIdx += 1 {
+		if l := len(n.colValues[valuesIdx]); scratchLen < l {
+			scratchLen = l
+		}
+	}
+	n.plan.freeRegister += scratchLen
+	for valuesIdx := 0; valuesIdx < rows; valuesIdx += 1 {
+		for vi := range n.colValues[valuesIdx] {
+			generateExpressionTo(
+				n.plan,
+				n.colValues[valuesIdx][vi],
+				scratchStart+vi,
+				n.cursorId,
+			)
+		}
+		n.plan.commands = append(n.plan.commands, &vm.MakeRecordCmd{
+			P1: scratchStart,
+			P2: len(n.colValues[valuesIdx]),
+			P3: recordStart + valuesIdx,
+		})
+	}
+	n.plan.commands = append(n.plan.commands, &vm.BatchInsertCmd{
+		P1: n.cursorId,
+		P2: keyStart,
+		P3: recordStart,
+		P5: rows,
+	})
+}
+
 func (d *deleteNode) consume() {
 	d.plan.commands = append(d.plan.commands, &vm.DeleteCmd{P1: d.cursorId})
 }
@@ -255,3 +329,70 @@ func (s *seekNode) consume() {
 	s.parent.consume()
 	seekCmd.P2 = len(s.plan.commands)
 }
+
+func (r *rangeSeekNode) produce() {
+	r.consume()
+}
+
+func (r *rangeSeekNode) consume() {
+	if r.isWriteCursor {
+		r.plan.commands = append(
+			r.plan.commands,
+			&vm.OpenWriteCmd{P1: r.cursorId, P2: r.rootPageNumber},
+		)
+	} else {
+		r.plan.commands = append(
+			r.plan.commands,
+			&vm.OpenReadCmd{P1: r.cursorId, P2: r.rootPageNumber},
+		)
+	}
+	// The upper bound is evaluated once before the loop.
+	upperRegister := 0
+	if r.upperBound != nil {
+		upperRegister = r.plan.freeRegister
+		r.plan.freeRegister += 1
+		generateExpressionTo(r.plan, r.upperBound, upperRegister, r.cursorId)
+	}
+	// Seek to the lower bound or rewind when the scan has no lower bound.
+	var seekCmd *vm.SeekGtCmd
+	var rewindCmd *vm.RewindCmd
+	if r.lowerBound != nil {
+		lowerRegister := r.plan.freeRegister
+		r.plan.freeRegister += 1
+		generateExpressionTo(r.plan, r.lowerBound, lowerRegister, r.cursorId)
+		seekCmd = &vm.SeekGtCmd{P1: r.cursorId, P3: lowerRegister}
+		r.plan.commands = append(r.plan.commands, seekCmd)
+	} else {
+		rewindCmd = &vm.RewindCmd{P1: r.cursorId}
+		r.plan.commands = append(r.plan.commands, rewindCmd)
+	}
+	loopBeginAddress := len(r.plan.commands)
+	// The loop terminates once the row id reaches the upper bound instead of
+	// filtering every remaining row.
+	var gteCmd *vm.GteCmd
+	if r.upperBound != nil {
+		rowIdRegister := r.plan.freeRegister
+		r.plan.freeRegister += 1
+		r.plan.commands = append(r.plan.commands, &vm.RowIdCmd{
+			P1: r.cursorId,
+			P2: rowIdRegister,
+		})
+		gteCmd = &vm.GteCmd{P1: rowIdRegister, P3: upperRegister}
+		r.plan.commands = append(r.plan.commands, gteCmd)
+	}
+	r.parent.consume()
+	r.plan.commands = append(r.plan.commands, &vm.NextCmd{
+		P1: r.cursorId,
+		P2: loopBeginAddress,
+	})
+	endAddress := len(r.plan.commands)
+	if seekCmd != nil {
+		seekCmd.P2 = endAddress
+	}
+	if rewindCmd != nil {
+		rewindCmd.P2 = endAddress
+	}
+	if gteCmd != nil {
+		gteCmd.P2 = endAddress
+	}
+}
@@ -43,6 +43,7 @@ func NewInsert(catalog insertCatalog, stmt *compiler.InsertStmt) *insertPlanner
 		executionPlan: vm.NewExecutionPlan(
 			catalog.GetVersion(),
 			stmt.Explain,
+			stmt.ExplainAnalyze,
 		),
 	}
 }
@@ -143,6 +144,8 @@ func (p *insertPlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
 	}
 	p.queryPlan.plan.compile()
 	p.executionPlan.Commands = p.queryPlan.plan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.plan.freeRegister
+	p.executionPlan.NumParams = p.queryPlan.plan.parameterCount()
 	return p.executionPlan, nil
 }
 
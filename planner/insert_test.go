@@ -37,31 +37,29 @@ func (m *mockInsertCatalog) GetPrimaryKeyColumn(tableName string) (string, error
 
 func TestInsertWithoutPrimaryKey(t *testing.T) {
 	expectedCommands := []vm.Command{
-		&vm.InitCmd{P2: 18},
+		&vm.InitCmd{P2: 16},
 		&vm.OpenWriteCmd{P1: 1, P2: 2},
 		&vm.NewRowIdCmd{P1: 1, P2: 1},
-		&vm.CopyCmd{P1: 4, P2: 2},
-		&vm.CopyCmd{P1: 5, P2: 3},
-		&vm.MakeRecordCmd{P1: 2, P2: 2, P3: 6},
-		&vm.InsertCmd{P1: 1, P2: 6, P3: 1},
-		&vm.NewRowIdCmd{P1: 1, P2: 7},
+		&vm.NewRowIdCmd{P1: 1, P2: 2},
+		&vm.NewRowIdCmd{P1: 1, P2: 3},
+		&vm.CopyCmd{P1: 9, P2: 7},
 		&vm.CopyCmd{P1: 10, P2: 8},
-		&vm.CopyCmd{P1: 11, P2: 9},
-		&vm.MakeRecordCmd{P1: 8, P2: 2, P3: 12},
-		&vm.InsertCmd{P1: 1, P2: 12, P3: 7},
-		&vm.NewRowIdCmd{P1: 1, P2: 13},
-		&vm.CopyCmd{P1: 16, P2: 14},
-		&vm.CopyCmd{P1: 17, P2: 15},
-		&vm.MakeRecordCmd{P1: 14, P2: 2, P3: 18},
-		&vm.InsertCmd{P1: 1, P2: 18, P3: 13},
+		&vm.MakeRecordCmd{P1: 7, P2: 2, P3: 4},
+		&vm.CopyCmd{P1: 11, P2: 7},
+		&vm.CopyCmd{P1: 12, P2: 8},
+		&vm.MakeRecordCmd{P1: 7, P2: 2, P3: 5},
+		&vm.CopyCmd{P1: 13, P2: 7},
+		&vm.CopyCmd{P1: 14, P2: 8},
+		&vm.MakeRecordCmd{P1: 7, P2: 2, P3: 6},
+		&vm.BatchInsertCmd{P1: 1, P2: 1, P3: 4, P5: 3},
 		&vm.HaltCmd{},
 		&vm.TransactionCmd{P2: 1},
-		&vm.StringCmd{P1: 4, P4: "gud"},
-		&vm.StringCmd{P1: 5, P4: "dude"},
-		&vm.StringCmd{P1: 10, P4: "joe"},
-		&vm.StringCmd{P1: 11, P4: "doe"},
-		&vm.StringCmd{P1: 16, P4: "jan"},
-		&vm.StringCmd{P1: 17, P4: "ice"},
+		&vm.StringCmd{P1: 9, P4: "gud"},
+		&vm.StringCmd{P1: 10, P4: "dude"},
+		&vm.StringCmd{P1: 11, P4: "joe"},
+		&vm.StringCmd{P1: 12, P4: "doe"},
+		&vm.StringCmd{P1: 13, P4: "jan"},
+		&vm.StringCmd{P1: 14, P4: "ice"},
 		&vm.GotoCmd{P2: 1},
 	}
 
@@ -4,6 +4,7 @@ import (
 	"fmt"
 
 	"github.com/chirst/cdb/compiler"
+	"github.com/chirst/cdb/vm"
 )
 
 // This file defines the relational nodes in a logical query plan.
@@ -26,6 +27,84 @@ type logicalNode interface {
 	setChildren(n ...logicalNode)
 }
 
+// transactionNode is a node emitting the command that opens, commits, or
+// rolls back an explicit transaction.
+type transactionNode struct {
+	plan *QueryPlan
+	// command is the transaction command the node emits.
+	command vm.Command
+	// description is the string representation for explain.
+	description string
+}
+
+func (t *transactionNode) print() string {
+	return t.description
+}
+
+func (t *transactionNode) produce() {
+	t.consume()
+}
+
+func (t *transactionNode) consume() {
+	t.plan.commands = append(t.plan.commands, t.command)
+}
+
+func (t *transactionNode) children() []logicalNode {
+	return []logicalNode{}
+}
+
+func (t *transactionNode) setChildren(n ...logicalNode) {}
+
+// vacuumNode emits the command that rebuilds every B tree to compact the
+// database file. Root page numbers change so the schema is reparsed.
+type vacuumNode struct {
+	plan *QueryPlan
+}
+
+func (v *vacuumNode) print() string {
+	return "vacuum"
+}
+
+func (v *vacuumNode) produce() {
+	v.consume()
+}
+
+func (v *vacuumNode) consume() {
+	v.plan.commands = append(v.plan.commands, &vm.VacuumCmd{})
+	v.plan.commands = append(v.plan.commands, &vm.ParseSchemaCmd{})
+}
+
+func (v *vacuumNode) children() []logicalNode {
+	return []logicalNode{}
+}
+
+func (v *vacuumNode) setChildren(n ...logicalNode) {}
+
+// analyzeNode emits the command that gathers table statistics. The statistics
+// are persisted as schema objects so the schema is reparsed.
+type analyzeNode struct {
+	plan *QueryPlan
+}
+
+func (a *analyzeNode) print() string {
+	return "analyze"
+}
+
+func (a *analyzeNode) produce() {
+	a.consume()
+}
+
+func (a *analyzeNode) consume() {
+	a.plan.commands = append(a.plan.commands, &vm.AnalyzeCmd{})
+	a.plan.commands = append(a.plan.commands, &vm.ParseSchemaCmd{})
+}
+
+func (a *analyzeNode) children() []logicalNode {
+	return []logicalNode{}
+}
+
+func (a *analyzeNode) setChildren(n ...logicalNode) {}
+
 // TODO joinNode is unused, but remains as a prototype binary operation node.
 type joinNode struct {
 	// left is the left subtree of the join.
@@ -240,6 +319,39 @@ func (s *seekNode) children() []logicalNode {
 
 func (s *seekNode) setChildren(n ...logicalNode) {}
 
+// rangeSeekNode represents a bounded scan of a table. The scan seeks to the
+// lower bound instead of starting at the first row and terminates at the upper
+// bound instead of the last row. Either bound may be nil meaning the scan is
+// unbounded on that side.
+type rangeSeekNode struct {
+	parent logicalNode
+	plan   *QueryPlan
+	// tableName is the name of the table being scanned.
+	tableName string
+	// rootPageNumber is the root page number of the table being scanned.
+	rootPageNumber int
+	// cursorId is the id of the cursor associated with the scan.
+	cursorId int
+	// isWriteCursor determines whether or not the cursor is for read or write.
+	isWriteCursor bool
+	// fullPredicate is the entire expression this node matches.
+	fullPredicate compiler.Expr
+	// lowerBound is the exclusive lower bound expression or nil.
+	lowerBound compiler.Expr
+	// upperBound is the exclusive upper bound expression or nil.
+	upperBound compiler.Expr
+}
+
+func (r *rangeSeekNode) print() string {
+	return fmt.Sprintf("range seek table %s (%s)", r.tableName, r.fullPredicate.Print())
+}
+
+func (r *rangeSeekNode) children() []logicalNode {
+	return []logicalNode{}
+}
+
+func (r *rangeSeekNode) setChildren(n ...logicalNode) {}
+
 type filterNode struct {
 	child     logicalNode
 	parent    logicalNode
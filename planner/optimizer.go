@@ -1,8 +1,32 @@
 package planner
 
-import "github.com/chirst/cdb/compiler"
+import (
+	"github.com/chirst/cdb/catalog"
+	"github.com/chirst/cdb/compiler"
+)
 
-type optimizer struct{}
+// Access path cost constants. Costs are measured in estimated page reads.
+const (
+	// descentCost is the estimated count of pages a root to leaf descent
+	// reads.
+	descentCost = 3
+	// defaultRangeSelectivity is the assumed fraction of a table selected by
+	// a range whose bound is unknown until the query runs such as a variable.
+	defaultRangeSelectivity = 0.25
+)
+
+// optimizerCatalog provides the table statistics the cost model reads.
+type optimizerCatalog interface {
+	GetStats(tableName string) (*catalog.TableStats, bool)
+}
+
+type optimizer struct {
+	// catalog provides the table statistics gathered by ANALYZE. The
+	// statistics drive the cost model choosing between access paths. A table
+	// that has never been analyzed has no statistics in which case the
+	// optimizer assumes the narrower access path is worth it.
+	catalog optimizerCatalog
+}
 
 func (o *optimizer) optimizePlan(plan *QueryPlan) {
 	if len(plan.root.children()) == 0 {
@@ -16,13 +40,32 @@ func (o *optimizer) optimizePlan(plan *QueryPlan) {
 	if !ok {
 		return
 	}
-	rowExpr := o.canOpt(filterNode.predicate)
-	if rowExpr == nil {
+	if rowExpr := o.canOpt(filterNode.predicate); rowExpr != nil {
+		// If the filter can be moved to a seek then remove the filter and push
+		// the predicate into a seek.
+		seekN := &seekNode{
+			parent:         filterNode.parent,
+			plan:           sn.plan,
+			tableName:      sn.tableName,
+			rootPageNumber: sn.rootPageNumber,
+			cursorId:       sn.cursorId,
+			isWriteCursor:  sn.isWriteCursor,
+			fullPredicate:  filterNode.predicate,
+			predicate:      rowExpr,
+		}
+		seekN.parent.setChildren(seekN)
+		return
+	}
+	lower, upper := o.canOptRange(filterNode.predicate)
+	if lower == nil && upper == nil {
+		return
+	}
+	if !o.rangeBeatsScan(sn.tableName, lower, upper) {
 		return
 	}
-	// If the filter can be moved to a seek then remove the filter and push the
-	// predicate into a seek.
-	seekN := &seekNode{
+	// A primary key comparison can be moved into a bounded scan. The filter is
+	// removed since the bounds enforce the predicate.
+	rangeN := &rangeSeekNode{
 		parent:         filterNode.parent,
 		plan:           sn.plan,
 		tableName:      sn.tableName,
@@ -30,9 +73,10 @@ func (o *optimizer) optimizePlan(plan *QueryPlan) {
 		cursorId:       sn.cursorId,
 		isWriteCursor:  sn.isWriteCursor,
 		fullPredicate:  filterNode.predicate,
-		predicate:      rowExpr,
+		lowerBound:     lower,
+		upperBound:     upper,
 	}
-	seekN.parent.setChildren(seekN)
+	rangeN.parent.setChildren(rangeN)
 }
 
 func (*optimizer) canOpt(predicate compiler.Expr) compiler.Expr {
@@ -64,3 +108,82 @@ func (*optimizer) canOpt(predicate compiler.Expr) compiler.Expr {
 	}
 	return nil
 }
+
+// canOptRange matches a primary key range comparison and returns the exclusive
+// lower and upper bound expressions. Both are nil when the predicate is not a
+// range on the primary key.
+func (o *optimizer) canOptRange(predicate compiler.Expr) (lower, upper compiler.Expr) {
+	be, ok := predicate.(*compiler.BinaryExpr)
+	if !ok || (be.Operator != compiler.OpGt && be.Operator != compiler.OpLt) {
+		return nil, nil
+	}
+	if lcr, ok := be.Left.(*compiler.ColumnRef); ok && lcr.IsPrimaryKey {
+		if c := rangeConstant(be.Right); c != nil {
+			if be.Operator == compiler.OpGt { // pk > c
+				return c, nil
+			}
+			return nil, c // pk < c
+		}
+	}
+	if rcr, ok := be.Right.(*compiler.ColumnRef); ok && rcr.IsPrimaryKey {
+		if c := rangeConstant(be.Left); c != nil {
+			if be.Operator == compiler.OpGt { // c > pk
+				return nil, c
+			}
+			return c, nil // c < pk
+		}
+	}
+	return nil, nil
+}
+
+// rangeBeatsScan compares the estimated cost of the bounded scan against a
+// full scan of the table. The bounded scan descends to the lower bound and
+// reads the leaf pages holding the selected rows while the full scan reads
+// every leaf page. A range covering nearly the whole table loses to the full
+// scan since the descent buys almost no pages. A table without statistics
+// assumes the bounded scan is worth it which matches the behavior before the
+// cost model existed.
+func (o *optimizer) rangeBeatsScan(tableName string, lower, upper compiler.Expr) bool {
+	stats, ok := o.catalog.GetStats(tableName)
+	if !ok || stats.RowCount == 0 || stats.LeafPages == 0 {
+		return true
+	}
+	scanCost := float64(stats.LeafPages)
+	rangeCost := descentCost + o.rangeSelectivity(stats, lower, upper)*scanCost
+	return rangeCost < scanCost
+}
+
+// rangeSelectivity estimates the fraction of the table selected by the
+// exclusive bounds assuming row ids are uniformly distributed between the
+// smallest and largest row id of the table.
+func (o *optimizer) rangeSelectivity(stats *catalog.TableStats, lower, upper compiler.Expr) float64 {
+	span := float64(stats.MaxRowID-stats.MinRowID) + 1
+	lo := float64(stats.MinRowID)
+	hi := float64(stats.MaxRowID)
+	if l, ok := lower.(*compiler.IntLit); ok {
+		lo = max(lo, float64(l.Value)+1)
+	} else if lower != nil {
+		return defaultRangeSelectivity
+	}
+	if u, ok := upper.(*compiler.IntLit); ok {
+		hi = min(hi, float64(u.Value)-1)
+	} else if upper != nil {
+		return defaultRangeSelectivity
+	}
+	if hi < lo {
+		return 0
+	}
+	return (hi - lo + 1) / span
+}
+
+// rangeConstant returns the expression when it is a constant a row id can be
+// compared against.
+func rangeConstant(e compiler.Expr) compiler.Expr {
+	switch t := e.(type) {
+	case *compiler.IntLit:
+		return t
+	case *compiler.Variable:
+		return t
+	}
+	return nil
+}
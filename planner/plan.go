@@ -57,6 +57,18 @@ func newQueryPlan(
 	}
 }
 
+// parameterCount returns the count of parameter slots the plan declares. It
+// is the highest variable position plus one since positions are zero based.
+func (p *QueryPlan) parameterCount() int {
+	count := 0
+	for position := range p.constVars {
+		if count < position+1 {
+			count = position + 1
+		}
+	}
+	return count
+}
+
 // transactionType defines possible transactions for a query plan.
 type transactionType int
 
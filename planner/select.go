@@ -17,6 +17,7 @@ type selectCatalog interface {
 	GetRootPageNumber(tableOrIndexName string) (int, error)
 	GetVersion() string
 	GetPrimaryKeyColumn(tableName string) (string, error)
+	GetStats(tableName string) (*catalog.TableStats, bool)
 }
 
 // selectPlanner is capable of generating a logical query plan and a physical
@@ -41,6 +42,7 @@ func NewSelect(catalog selectCatalog, stmt *compiler.SelectStmt) *selectPlanner
 		executionPlan: vm.NewExecutionPlan(
 			catalog.GetVersion(),
 			stmt.Explain,
+			stmt.ExplainAnalyze,
 		),
 	}
 }
@@ -88,6 +90,12 @@ func (p *selectPlanner) QueryPlan() (*QueryPlan, error) {
 		if tableName == "" {
 			return nil, errors.New("must have from for COUNT")
 		}
+		// An unfiltered COUNT lowers onto the page record counter sum which
+		// cannot apply a predicate. Erroring beats silently dropping the
+		// predicate.
+		if p.stmt.Where != nil {
+			return nil, errors.New("COUNT with WHERE is not supported")
+		}
 		cn := &countNode{
 			projection:     projections[0],
 			rootPageNumber: rootPageNumber,
@@ -161,7 +169,7 @@ func (p *selectPlanner) QueryPlan() (*QueryPlan, error) {
 	}
 	p.queryPlan = plan
 	plan.root = projectNode
-	(&optimizer{}).optimizePlan(plan)
+	(&optimizer{catalog: p.catalog}).optimizePlan(plan)
 	return plan, nil
 }
 
@@ -178,6 +186,8 @@ func (sp *selectPlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
 	sp.setResultHeader()
 	sp.queryPlan.compile()
 	sp.executionPlan.Commands = sp.queryPlan.commands
+	sp.executionPlan.MaxRegister = sp.queryPlan.freeRegister
+	sp.executionPlan.NumParams = sp.queryPlan.parameterCount()
 	return sp.executionPlan, nil
 }
 
@@ -13,6 +13,7 @@ type mockSelectCatalog struct {
 	columns              []string
 	columnTypes          []catalog.CdbType
 	primaryKeyColumnName string
+	stats                *catalog.TableStats
 }
 
 func (m *mockSelectCatalog) GetColumns(s string) ([]string, error) {
@@ -47,6 +48,13 @@ func (m *mockSelectCatalog) GetColumnType(tableName string, columnName string) (
 	return catalog.CdbType{ID: catalog.CTUnknown}, nil
 }
 
+func (m *mockSelectCatalog) GetStats(tableName string) (*catalog.TableStats, bool) {
+	if m.stats == nil {
+		return nil, false
+	}
+	return m.stats, true
+}
+
 func TestSelectPlan(t *testing.T) {
 	type selectCase struct {
 		description      string
@@ -523,6 +531,173 @@ func TestUsePrimaryKeyIndex(t *testing.T) {
 	}
 }
 
+func TestUsePrimaryKeyRange(t *testing.T) {
+	ast := &compiler.SelectStmt{
+		StmtBase: &compiler.StmtBase{},
+		From: &compiler.From{
+			TableName: "foo",
+		},
+		ResultColumns: []compiler.ResultColumn{
+			{
+				All: true,
+			},
+		},
+		Where: &compiler.BinaryExpr{
+			Left:     &compiler.ColumnRef{Column: "id"},
+			Right:    &compiler.IntLit{Value: 10},
+			Operator: compiler.OpGt,
+		},
+	}
+	mockCatalog := &mockSelectCatalog{
+		primaryKeyColumnName: "id",
+	}
+	qp, err := NewSelect(mockCatalog, ast).QueryPlan()
+	if err != nil {
+		t.Errorf("expected no err got err %s", err)
+	}
+	if pn, ok := qp.root.(*projectNode); ok {
+		if rangeN, ok := pn.child.(*rangeSeekNode); ok {
+			if rangeN.parent != pn {
+				t.Error("expected parent to be pn")
+			}
+			if rangeN.lowerBound == nil {
+				t.Error("expected lower bound for >")
+			}
+			if rangeN.upperBound != nil {
+				t.Error("expected no upper bound for >")
+			}
+		} else {
+			t.Errorf("expected range seek node but got %#v", pn.child)
+		}
+	} else {
+		t.Errorf("expected project node but got %#v", qp.root)
+	}
+}
+
+func TestCountWithWhereErrs(t *testing.T) {
+	ast := &compiler.SelectStmt{
+		StmtBase: &compiler.StmtBase{},
+		From: &compiler.From{
+			TableName: "foo",
+		},
+		ResultColumns: []compiler.ResultColumn{
+			{
+				Expression: &compiler.FunctionExpr{FnType: compiler.FnCount},
+			},
+		},
+		Where: &compiler.BinaryExpr{
+			Left:     &compiler.ColumnRef{Column: "id"},
+			Right:    &compiler.IntLit{Value: 1},
+			Operator: compiler.OpEq,
+		},
+	}
+	mockCatalog := &mockSelectCatalog{
+		primaryKeyColumnName: "id",
+	}
+	if _, err := NewSelect(mockCatalog, ast).QueryPlan(); err == nil {
+		t.Error("expected err for COUNT with WHERE since the count cannot apply the predicate")
+	}
+}
+
+func TestRangeSeekCostModel(t *testing.T) {
+	makeAst := func(lowerBound int) *compiler.SelectStmt {
+		return &compiler.SelectStmt{
+			StmtBase: &compiler.StmtBase{},
+			From: &compiler.From{
+				TableName: "foo",
+			},
+			ResultColumns: []compiler.ResultColumn{
+				{
+					All: true,
+				},
+			},
+			Where: &compiler.BinaryExpr{
+				Left:     &compiler.ColumnRef{Column: "id"},
+				Right:    &compiler.IntLit{Value: lowerBound},
+				Operator: compiler.OpGt,
+			},
+		}
+	}
+	makeCatalog := func() *mockSelectCatalog {
+		return &mockSelectCatalog{
+			primaryKeyColumnName: "id",
+			stats: &catalog.TableStats{
+				RowCount:  1_000,
+				LeafPages: 100,
+				MinRowID:  1,
+				MaxRowID:  1_000,
+			},
+		}
+	}
+
+	t.Run("selective range becomes a range seek", func(t *testing.T) {
+		qp, err := NewSelect(makeCatalog(), makeAst(990)).QueryPlan()
+		if err != nil {
+			t.Errorf("expected no err got err %s", err)
+		}
+		pn := qp.root.(*projectNode)
+		if _, ok := pn.child.(*rangeSeekNode); !ok {
+			t.Errorf("expected range seek node but got %#v", pn.child)
+		}
+	})
+
+	t.Run("whole table range stays a scan", func(t *testing.T) {
+		qp, err := NewSelect(makeCatalog(), makeAst(0)).QueryPlan()
+		if err != nil {
+			t.Errorf("expected no err got err %s", err)
+		}
+		pn := qp.root.(*projectNode)
+		fn, ok := pn.child.(*filterNode)
+		if !ok {
+			t.Fatalf("expected filter node but got %#v", pn.child)
+		}
+		if _, ok := fn.child.(*scanNode); !ok {
+			t.Errorf("expected scan node but got %#v", fn.child)
+		}
+	})
+}
+
+func TestUsePrimaryKeyRangeFlippedOperands(t *testing.T) {
+	ast := &compiler.SelectStmt{
+		StmtBase: &compiler.StmtBase{},
+		From: &compiler.From{
+			TableName: "foo",
+		},
+		ResultColumns: []compiler.ResultColumn{
+			{
+				All: true,
+			},
+		},
+		// 10 > id meaning id < 10
+		Where: &compiler.BinaryExpr{
+			Left:     &compiler.IntLit{Value: 10},
+			Right:    &compiler.ColumnRef{Column: "id"},
+			Operator: compiler.OpGt,
+		},
+	}
+	mockCatalog := &mockSelectCatalog{
+		primaryKeyColumnName: "id",
+	}
+	qp, err := NewSelect(mockCatalog, ast).QueryPlan()
+	if err != nil {
+		t.Errorf("expected no err got err %s", err)
+	}
+	if pn, ok := qp.root.(*projectNode); ok {
+		if rangeN, ok := pn.child.(*rangeSeekNode); ok {
+			if rangeN.lowerBound != nil {
+				t.Error("expected no lower bound for flipped >")
+			}
+			if rangeN.upperBound == nil {
+				t.Error("expected upper bound for flipped >")
+			}
+		} else {
+			t.Errorf("expected range seek node but got %#v", pn.child)
+		}
+	} else {
+		t.Errorf("expected project node but got %#v", qp.root)
+	}
+}
+
 func TestUsePrimaryKeyIndexFlippedOperands(t *testing.T) {
 	ast := &compiler.SelectStmt{
 		StmtBase: &compiler.StmtBase{},
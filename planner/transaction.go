@@ -0,0 +1,109 @@
+package planner
+
+import (
+	"github.com/chirst/cdb/compiler"
+	"github.com/chirst/cdb/vm"
+)
+
+// transactionCatalog defines the catalog methods needed by the transaction
+// planner.
+type transactionCatalog interface {
+	GetVersion() string
+}
+
+// transactionPlanner generates plans for the BEGIN, COMMIT, and ROLLBACK
+// statements. Each statement compiles to a single command that opens, commits,
+// or rolls back the explicit transaction in the vm.
+type transactionPlanner struct {
+	// stmt contains the AST.
+	stmt *compiler.StmtBase
+	// command is the transaction command the plan executes.
+	command vm.Command
+	// description is the string representation for explain query plan.
+	description string
+	// queryPlan contains the plan being built.
+	queryPlan *QueryPlan
+	// executionPlan contains the execution plan for the vm. This is built by
+	// calling ExecutionPlan.
+	executionPlan *vm.ExecutionPlan
+}
+
+// NewBegin returns an instance of a transaction planner for a begin statement.
+func NewBegin(catalog transactionCatalog, stmt *compiler.BeginStmt) *transactionPlanner {
+	return newTransactionPlanner(
+		catalog,
+		stmt.StmtBase,
+		&vm.BeginCmd{},
+		"begin transaction",
+	)
+}
+
+// NewCommit returns an instance of a transaction planner for a commit
+// statement.
+func NewCommit(catalog transactionCatalog, stmt *compiler.CommitStmt) *transactionPlanner {
+	return newTransactionPlanner(
+		catalog,
+		stmt.StmtBase,
+		&vm.CommitCmd{},
+		"commit transaction",
+	)
+}
+
+// NewRollback returns an instance of a transaction planner for a rollback
+// statement.
+func NewRollback(catalog transactionCatalog, stmt *compiler.RollbackStmt) *transactionPlanner {
+	return newTransactionPlanner(
+		catalog,
+		stmt.StmtBase,
+		&vm.RollbackCmd{},
+		"rollback transaction",
+	)
+}
+
+func newTransactionPlanner(
+	catalog transactionCatalog,
+	stmt *compiler.StmtBase,
+	command vm.Command,
+	description string,
+) *transactionPlanner {
+	return &transactionPlanner{
+		stmt:        stmt,
+		command:     command,
+		description: description,
+		executionPlan: vm.NewExecutionPlan(
+			catalog.GetVersion(),
+			stmt.Explain,
+			stmt.ExplainAnalyze,
+		),
+	}
+}
+
+// QueryPlan generates the query plan tree for the planner.
+func (p *transactionPlanner) QueryPlan() (*QueryPlan, error) {
+	tn := &transactionNode{
+		command:     p.command,
+		description: p.description,
+	}
+	// The explicit transaction is managed by the command itself so the plan
+	// does not open a transaction of its own.
+	plan := newQueryPlan(tn, p.stmt.ExplainQueryPlan, transactionTypeNone)
+	tn.plan = plan
+	p.queryPlan = plan
+	return plan, nil
+}
+
+// ExecutionPlan returns the bytecode execution plan for the planner. Calling
+// QueryPlan is not a prerequisite to this method as it will be called by
+// ExecutionPlan if needed.
+func (p *transactionPlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
+	if p.queryPlan == nil {
+		_, err := p.QueryPlan()
+		if err != nil {
+			return nil, err
+		}
+	}
+	p.queryPlan.compile()
+	p.executionPlan.Commands = p.queryPlan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.freeRegister
+	return p.executionPlan, nil
+}
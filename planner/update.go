@@ -16,6 +16,7 @@ type updateCatalog interface {
 	GetColumns(string) ([]string, error)
 	GetPrimaryKeyColumn(string) (string, error)
 	GetColumnType(tableName string, columnName string) (catalog.CdbType, error)
+	GetStats(tableName string) (*catalog.TableStats, bool)
 }
 
 // updatePanner houses the query planner and execution planner for a update
@@ -35,6 +36,7 @@ func NewUpdate(catalog updateCatalog, stmt *compiler.UpdateStmt) *updatePlanner
 		executionPlan: vm.NewExecutionPlan(
 			catalog.GetVersion(),
 			stmt.Explain,
+			stmt.ExplainAnalyze,
 		),
 	}
 }
@@ -96,7 +98,7 @@ func (p *updatePlanner) QueryPlan() (*QueryPlan, error) {
 		scanNode.parent = updateNode
 		updateNode.child = scanNode
 	}
-	(&optimizer{}).optimizePlan(logicalPlan)
+	(&optimizer{catalog: p.catalog}).optimizePlan(logicalPlan)
 	return logicalPlan, nil
 }
 
@@ -182,5 +184,7 @@ func (p *updatePlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
 	}
 	p.queryPlan.plan.compile()
 	p.executionPlan.Commands = p.queryPlan.plan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.plan.freeRegister
+	p.executionPlan.NumParams = p.queryPlan.plan.parameterCount()
 	return p.executionPlan, nil
 }
@@ -44,6 +44,10 @@ func (mockUpdateCatalog) GetColumnType(tableName string, columnName string) (cat
 	return catalog.CdbType{ID: catalog.CTInt}, nil
 }
 
+func (*mockUpdateCatalog) GetStats(tableName string) (*catalog.TableStats, bool) {
+	return nil, false
+}
+
 func TestUpdate(t *testing.T) {
 	ast := &compiler.UpdateStmt{
 		StmtBase:  &compiler.StmtBase{},
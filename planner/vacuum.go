@@ -0,0 +1,61 @@
+package planner
+
+import (
+	"github.com/chirst/cdb/compiler"
+	"github.com/chirst/cdb/vm"
+)
+
+// vacuumCatalog defines the catalog methods needed by the vacuum planner.
+type vacuumCatalog interface {
+	GetVersion() string
+}
+
+// vacuumPlanner generates plans for the VACUUM statement. The plan rebuilds
+// every B tree with the bulk load path inside a write transaction and
+// reparses the schema since root page numbers change.
+type vacuumPlanner struct {
+	// stmt contains the AST.
+	stmt *compiler.VacuumStmt
+	// queryPlan contains the plan being built.
+	queryPlan *QueryPlan
+	// executionPlan contains the execution plan for the vm. This is built by
+	// calling ExecutionPlan.
+	executionPlan *vm.ExecutionPlan
+}
+
+// NewVacuum returns an instance of a vacuum planner for the given statement.
+func NewVacuum(catalog vacuumCatalog, stmt *compiler.VacuumStmt) *vacuumPlanner {
+	return &vacuumPlanner{
+		stmt: stmt,
+		executionPlan: vm.NewExecutionPlan(
+			catalog.GetVersion(),
+			stmt.Explain,
+			stmt.ExplainAnalyze,
+		),
+	}
+}
+
+// QueryPlan generates the query plan tree for the planner.
+func (p *vacuumPlanner) QueryPlan() (*QueryPlan, error) {
+	vn := &vacuumNode{}
+	plan := newQueryPlan(vn, p.stmt.ExplainQueryPlan, transactionTypeWrite)
+	vn.plan = plan
+	p.queryPlan = plan
+	return plan, nil
+}
+
+// ExecutionPlan returns the bytecode execution plan for the planner. Calling
+// QueryPlan is not a prerequisite to this method as it will be called by
+// ExecutionPlan if needed.
+func (p *vacuumPlanner) ExecutionPlan() (*vm.ExecutionPlan, error) {
+	if p.queryPlan == nil {
+		_, err := p.QueryPlan()
+		if err != nil {
+			return nil, err
+		}
+	}
+	p.queryPlan.compile()
+	p.executionPlan.Commands = p.queryPlan.commands
+	p.executionPlan.MaxRegister = p.queryPlan.freeRegister
+	return p.executionPlan, nil
+}
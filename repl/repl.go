@@ -85,7 +85,9 @@ func (r *repl) Run() {
 		}
 		previousInput = ""
 		for _, statement := range statements {
-			result := r.db.Execute(statement, []any{})
+			rows := r.db.ExecuteRows(statement, []any{})
+			r.printRows(rows)
+			result := rows.Result()
 			if result.Err != nil {
 				r.writeLn("Err: " + result.Err.Error())
 				continue
@@ -93,9 +95,6 @@ func (r *repl) Run() {
 			if result.Text != "" {
 				r.writeLn(result.Text)
 			}
-			if len(result.ResultRows) != 0 {
-				r.writeLn(r.printRows(result.ResultHeader, result.ResultRows))
-			}
 			r.writeLn("Time: " + result.Duration.String())
 		}
 	}
@@ -133,23 +132,25 @@ func (r *repl) writeWarning(text string) {
 	r.terminal.Write(r.terminal.Escape.Reset)
 }
 
-func (r *repl) printRows(resultHeader []string, resultRows [][]*string) string {
-	ret := ""
-	widths := r.getWidths(resultHeader, resultRows)
-	ret += r.printHeader(resultHeader, widths)
-	ret = ret + "\n"
-	for _, row := range resultRows {
-		ret += r.printRow(row, widths)
-		ret = ret + "\n"
+// printRows prints the rows of the executing statement as they stream from
+// the database so the whole result is never held in memory. The column widths
+// are sized from the header and the first row since sizing from every row
+// would mean materializing the full result.
+func (r *repl) printRows(rows *db.Rows) {
+	row, ok := rows.Next()
+	if !ok {
+		return
 	}
-	if len(resultRows) == 0 {
-		ret = ret + "(0 rows)\n"
+	widths := r.getWidths(rows.Header(), row)
+	r.writeLn(r.printHeader(rows.Header(), widths))
+	for ok {
+		r.writeLn(r.printRow(row, widths))
+		row, ok = rows.Next()
 	}
-	return ret
 }
 
-func (*repl) getWidths(header []string, rows [][]*string) []int {
-	widths := make([]int, len(rows[0]))
+func (*repl) getWidths(header []string, row []*string) []int {
+	widths := make([]int, len(row))
 	for i := range widths {
 		widths[i] = 0
 	}
@@ -162,15 +163,13 @@ func (*repl) getWidths(header []string, rows [][]*string) []int {
 			widths[i] = size
 		}
 	}
-	for _, row := range rows {
-		for i, column := range row {
-			size := len(emptyRowValue)
-			if column != nil {
-				size = len(*column)
-			}
-			if widths[i] < size {
-				widths[i] = size
-			}
+	for i, column := range row {
+		size := len(emptyRowValue)
+		if column != nil {
+			size = len(*column)
+		}
+		if widths[i] < size {
+			widths[i] = size
 		}
 	}
 	return widths
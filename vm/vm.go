@@ -8,6 +8,7 @@ import (
 	"fmt"
 	"math"
 	"regexp"
+	"slices"
 	"strconv"
 	"time"
 
@@ -21,6 +22,10 @@ var ErrVersionChanged = errors.New("statement was compiled with an out of date c
 
 type vm struct {
 	kv *kv.KV
+	// explicitWriteTransaction is true while a transaction opened by BEGIN is
+	// waiting for COMMIT or ROLLBACK. Statements executed while it is true
+	// share the open write transaction instead of committing individually.
+	explicitWriteTransaction bool
 }
 
 func New(kv *kv.KV) *vm {
@@ -31,8 +36,16 @@ func New(kv *kv.KV) *vm {
 
 // routine contains values that are destroyed when a plan is finished executing
 type routine struct {
-	registers        map[int]any
-	resultRows       *[][]*string
+	// registers is the register file for the routine. Register numbers are
+	// dense and assigned at plan time so the file is a pre sized slice making
+	// a register access an index instead of a hash lookup.
+	registers  []any
+	resultRows *[][]*string
+	// onResultRow is called with each result row as it is produced instead of
+	// appending the row to resultRows. This keeps memory bounded by one row
+	// for consumers able to process rows incrementally. A nil onResultRow
+	// means rows accumulate in resultRows.
+	onResultRow      func([]*string) error
 	cursors          map[int]*kv.Cursor
 	parameters       []any
 	readTransaction  bool
@@ -80,8 +93,19 @@ type ExecuteResult struct {
 }
 
 type ExecutionPlan struct {
-	Explain  bool
+	Explain bool
+	// Analyze means the plan is executed while accumulating per command
+	// invocation counts and cumulative time. The counters are returned as the
+	// result instead of the result rows.
+	Analyze  bool
 	Commands []Command
+	// MaxRegister is the highest register number used by the commands. The
+	// planner records this so the routine can size its register file up front.
+	MaxRegister int
+	// NumParams is the count of parameter slots the statement declares. The
+	// planner records this at compile time so binding is validated before
+	// the routine runs.
+	NumParams int
 	// ResultHeader is the names of columns in the result.
 	ResultHeader []string
 	// ResultTypes are the types for each result column.
@@ -91,10 +115,11 @@ type ExecutionPlan struct {
 	Version string
 }
 
-func NewExecutionPlan(version string, explain bool) *ExecutionPlan {
+func NewExecutionPlan(version string, explain bool, analyze bool) *ExecutionPlan {
 	return &ExecutionPlan{
 		Version: version,
 		Explain: explain,
+		Analyze: analyze,
 	}
 }
 
@@ -107,32 +132,76 @@ func (e *ExecutionPlan) Append(command Command) {
 // the system catalog Execute will return ErrVersionChanged in the ExecuteResult
 // err field so the plan can be recompiled.
 func (v *vm) Execute(plan *ExecutionPlan, parameters []any) *ExecuteResult {
+	return v.execute(plan, parameters, nil)
+}
+
+// ExecuteRows performs the execution plan like Execute except each result row
+// is passed to onResultRow as it is produced instead of accumulating in the
+// result. This bounds memory to a single row for arbitrarily large results. An
+// error returned by onResultRow stops the execution and rolls back like any
+// other execution error. Explain and analyze plans keep materializing their
+// rows in the result since their size is bounded by the plan.
+func (v *vm) ExecuteRows(plan *ExecutionPlan, parameters []any, onResultRow func([]*string) error) *ExecuteResult {
+	return v.execute(plan, parameters, onResultRow)
+}
+
+func (v *vm) execute(plan *ExecutionPlan, parameters []any, onResultRow func([]*string) error) *ExecuteResult {
 	parameters = v.normalizeParameters(parameters)
 	if plan.Explain {
 		return v.explain(plan)
 	}
-	if err := v.resolveVarTypes(plan, parameters); err != nil {
+	if err := v.errForMissingParams(plan, parameters); err != nil {
+		return &ExecuteResult{Err: err}
+	}
+	resolvedTypes, err := plan.ResolveTypes(parameters)
+	if err != nil {
 		return &ExecuteResult{Err: err}
 	}
-	if err := v.errForUnknownType(plan); err != nil {
+	if err := v.errForUnknownType(resolvedTypes); err != nil {
 		return &ExecuteResult{Err: err}
 	}
+	if plan.Analyze {
+		// An analyzed execution returns the per command counters instead of
+		// the result rows so there is nothing to stream.
+		onResultRow = nil
+	}
 	routine := &routine{
-		registers:        map[int]any{},
+		registers:        make([]any, registerFileSize(plan.MaxRegister)),
 		resultRows:       &[][]*string{},
+		onResultRow:      onResultRow,
 		cursors:          map[int]*kv.Cursor{},
 		parameters:       parameters,
 		readTransaction:  false,
 		writeTransaction: false,
 		schemaVersion:    plan.Version,
 	}
+	var counts []int
+	var times []time.Duration
+	var startHits, startMisses int
+	if plan.Analyze {
+		counts = make([]int, len(plan.Commands))
+		times = make([]time.Duration, len(plan.Commands))
+		startHits, startMisses = v.kv.PageCacheStats()
+	}
 	i := 0
 	var currentCommand Command
 	for i < len(plan.Commands) {
 		currentCommand = plan.Commands[i]
+		var commandStart time.Time
+		if plan.Analyze {
+			commandStart = time.Now()
+		}
 		res := currentCommand.execute(v, routine)
+		if plan.Analyze {
+			counts[i] += 1
+			times[i] += time.Since(commandStart)
+		}
 		if res.err != nil {
-			v.rollback(routine)
+			// A version change inside an explicit transaction only means the
+			// statement is recompiled. The transaction itself stays open.
+			if !(v.explicitWriteTransaction && errors.Is(res.err, ErrVersionChanged)) {
+				v.rollback(routine)
+			}
 			return &ExecuteResult{Err: res.err}
 		}
 		if res.doHalt {
@@ -144,13 +213,60 @@ func (v *vm) Execute(plan *ExecutionPlan, parameters []any) *ExecuteResult {
 			i = res.nextAddress
 		}
 	}
+	if plan.Analyze {
+		return v.analyze(plan, counts, times, startHits, startMisses)
+	}
 	return &ExecuteResult{
 		ResultRows:   *routine.resultRows,
 		ResultHeader: plan.ResultHeader,
-		ResultTypes:  plan.ResultTypes,
+		ResultTypes:  resolvedTypes,
 	}
 }
 
+// analyze builds the result for an analyzed execution. Each command is a row
+// with its invocation count and cumulative time followed by a row for the
+// page cache hits and misses the execution caused.
+func (v *vm) analyze(plan *ExecutionPlan, counts []int, times []time.Duration, startHits, startMisses int) *ExecuteResult {
+	resultRows := [][]*string{}
+	for i, command := range plan.Commands {
+		e := command.explain(i)
+		ca := strconv.Itoa(counts[i])
+		ta := times[i].String()
+		resultRows = append(resultRows, []*string{e[0], e[1], &ca, &ta, e[7]})
+	}
+	hits, misses := v.kv.PageCacheStats()
+	dash := "-"
+	empty := ""
+	hitLabel := "PageCacheHit"
+	ha := strconv.Itoa(hits - startHits)
+	resultRows = append(resultRows, []*string{&dash, &hitLabel, &ha, &empty, &empty})
+	missLabel := "PageCacheMiss"
+	ma := strconv.Itoa(misses - startMisses)
+	resultRows = append(resultRows, []*string{&dash, &missLabel, &ma, &empty, &empty})
+	return &ExecuteResult{
+		ResultRows: resultRows,
+		ResultHeader: []string{
+			"addr",
+			"opcode",
+			"count",
+			"time",
+			"comment",
+		},
+	}
+}
+
+// minRegisterFileSize is the smallest register file allocated for a routine.
+// It covers plans built outside the planner that do not record a max register.
+const minRegisterFileSize = 32
+
+// registerFileSize returns the count of registers to allocate for a plan.
+func registerFileSize(maxRegister int) int {
+	if maxRegister+1 < minRegisterFileSize {
+		return minRegisterFileSize
+	}
+	return maxRegister + 1
+}
+
 // normalizeParameters converts parameters to a simpler type. This is because of
 // things like a int vs int64 producing different byte array values. This can
 // for example cause bugs with comparisons within the key value store.
@@ -168,29 +284,56 @@ func (v *vm) normalizeParameters(parameters []any) []any {
 	return parameters
 }
 
-// resolveVarTypes takes unresolved var types in the result types and determines
-// their type from the passed in go type.
-func (v *vm) resolveVarTypes(plan *ExecutionPlan, parameters []any) error {
-	for i := range plan.ResultTypes {
-		if plan.ResultTypes[i].ID == catalog.CTVar {
-			switch parameters[plan.ResultTypes[i].VarPosition].(type) {
-			case int:
-				plan.ResultTypes[i].ID = catalog.CTInt
-			case string:
-				plan.ResultTypes[i].ID = catalog.CTStr
-			default:
-				return fmt.Errorf("unsupported var %v", parameters[i])
-			}
-		}
+// errForMissingParams guarantees every parameter slot the plan declared at
+// compile time is bound before the routine runs instead of failing at a
+// VariableCmd somewhere mid plan.
+func (v *vm) errForMissingParams(plan *ExecutionPlan, parameters []any) error {
+	if len(parameters) < plan.NumParams {
+		return fmt.Errorf(
+			"statement expects %d parameters got %d",
+			plan.NumParams,
+			len(parameters),
+		)
 	}
 	return nil
 }
 
+// ResolveTypes returns the result types with variable slots resolved from the
+// bound parameters. The plan itself is never mutated since a cached plan is
+// shared between executions. A plan without variable result types returns its
+// precomputed types without copying.
+func (e *ExecutionPlan) ResolveTypes(parameters []any) ([]catalog.CdbType, error) {
+	resolved := e.ResultTypes
+	copied := false
+	for i := range resolved {
+		if resolved[i].ID != catalog.CTVar {
+			continue
+		}
+		if !copied {
+			resolved = slices.Clone(e.ResultTypes)
+			copied = true
+		}
+		pos := resolved[i].VarPosition
+		if len(parameters) <= pos {
+			return nil, fmt.Errorf("no variable at index %d", pos)
+		}
+		switch parameters[pos].(type) {
+		case int, int16, int32, int64:
+			resolved[i] = catalog.CdbType{ID: catalog.CTInt}
+		case string:
+			resolved[i] = catalog.CdbType{ID: catalog.CTStr}
+		default:
+			return nil, fmt.Errorf("unsupported var %v", parameters[pos])
+		}
+	}
+	return resolved, nil
+}
+
 // errForUnknownType guarantees the result types will be known or the query
 // will fail before execution.
-func (v *vm) errForUnknownType(plan *ExecutionPlan) error {
-	for i := range plan.ResultTypes {
-		if plan.ResultTypes[i].ID == catalog.CTUnknown {
+func (v *vm) errForUnknownType(types []catalog.CdbType) error {
+	for i := range types {
+		if types[i].ID == catalog.CTUnknown {
 			return fmt.Errorf("unknown type at position %d", i)
 		}
 	}
@@ -198,6 +341,13 @@ func (v *vm) errForUnknownType(plan *ExecutionPlan) error {
 }
 
 func (v *vm) rollback(r *routine) {
+	// An error inside an explicit transaction rolls back the whole
+	// transaction.
+	if v.explicitWriteTransaction {
+		v.explicitWriteTransaction = false
+		v.kv.RollbackWrite()
+		return
+	}
 	if r.writeTransaction {
 		v.kv.RollbackWrite()
 		return
@@ -250,6 +400,10 @@ func (v *vm) explain(plan *ExecutionPlan) *ExecuteResult {
 	}
 }
 
+// nonDigits strips everything but digits from a string being coerced to an
+// int. It is compiled once since anyToInt sits on the execution hot path.
+var nonDigits = regexp.MustCompile(`\D`)
+
 func anyToInt(a any) (int, error) {
 	switch t := a.(type) {
 	case int:
@@ -257,7 +411,7 @@ func anyToInt(a any) (int, error) {
 	case int64:
 		return int(t), nil
 	case string:
-		s := regexp.MustCompile(`\D`).ReplaceAllString(t, "")
+		s := nonDigits.ReplaceAllString(t, "")
 		if s == "" {
 			return 0, nil
 		}
@@ -308,6 +462,13 @@ func (c *HaltCmd) execute(vm *vm, routine *routine) cmdRes {
 			err: errors.New(em),
 		}
 	}
+	// An explicit transaction stays open across statements and is ended by
+	// COMMIT or ROLLBACK.
+	if vm.explicitWriteTransaction {
+		return cmdRes{
+			doHalt: true,
+		}
+	}
 	if routine.readTransaction {
 		vm.kv.EndReadTransaction()
 	}
@@ -336,6 +497,16 @@ func (c *HaltCmd) explain(addr int) []*string {
 type TransactionCmd cmd
 
 func (c *TransactionCmd) execute(vm *vm, routine *routine) cmdRes {
+	// Statements inside an explicit transaction share the already open write
+	// transaction. The routine is marked as a write transaction so read
+	// cursors see the transaction's own uncommitted writes.
+	if vm.explicitWriteTransaction {
+		routine.writeTransaction = true
+		if routine.schemaVersion != vm.kv.GetCatalog().GetVersion() {
+			return cmdRes{err: ErrVersionChanged}
+		}
+		return cmdRes{}
+	}
 	if c.P2 == 0 {
 		routine.readTransaction = true
 		if err := vm.kv.BeginReadTransaction(); err != nil {
@@ -369,11 +540,75 @@ func (c *TransactionCmd) explain(addr int) []*string {
 	return formatExplain(addr, "Transaction", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
 }
 
+// BeginCmd opens an explicit write transaction. The transaction is shared by
+// the statements that follow until a CommitCmd or RollbackCmd ends it.
+type BeginCmd cmd
+
+func (c *BeginCmd) execute(vm *vm, routine *routine) cmdRes {
+	if vm.explicitWriteTransaction {
+		return cmdRes{err: errors.New("transaction already open")}
+	}
+	if err := vm.kv.BeginWriteTransaction(); err != nil {
+		return cmdRes{err: err}
+	}
+	vm.explicitWriteTransaction = true
+	return cmdRes{}
+}
+
+func (c *BeginCmd) explain(addr int) []*string {
+	comment := "Begin an explicit write transaction"
+	return formatExplain(addr, "Begin", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
+// CommitCmd commits the open explicit write transaction.
+type CommitCmd cmd
+
+func (c *CommitCmd) execute(vm *vm, routine *routine) cmdRes {
+	if !vm.explicitWriteTransaction {
+		return cmdRes{err: errors.New("no transaction open")}
+	}
+	vm.explicitWriteTransaction = false
+	if err := vm.kv.EndWriteTransaction(); err != nil {
+		return cmdRes{err: err}
+	}
+	return cmdRes{}
+}
+
+func (c *CommitCmd) explain(addr int) []*string {
+	comment := "Commit the explicit write transaction"
+	return formatExplain(addr, "Commit", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
+// RollbackCmd rolls back the open explicit write transaction.
+type RollbackCmd cmd
+
+func (c *RollbackCmd) execute(vm *vm, routine *routine) cmdRes {
+	if !vm.explicitWriteTransaction {
+		return cmdRes{err: errors.New("no transaction open")}
+	}
+	vm.explicitWriteTransaction = false
+	vm.kv.RollbackWrite()
+	return cmdRes{}
+}
+
+func (c *RollbackCmd) explain(addr int) []*string {
+	comment := "Rollback the explicit write transaction"
+	return formatExplain(addr, "Rollback", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
 // OpenReadCmd opens a read cursor with identifier P1 at page P2
 type OpenReadCmd cmd
 
 func (c *OpenReadCmd) execute(vm *vm, routine *routine) cmdRes {
-	routine.cursors[c.P1] = vm.kv.NewCursor(c.P2)
+	// Cursors in a pure read transaction are snapshot cursors so the routine
+	// can read concurrently with a write transaction preparing its dirty page
+	// set. Read cursors in a write transaction must see the routine's own
+	// uncommitted writes.
+	if routine.writeTransaction {
+		routine.cursors[c.P1] = vm.kv.NewCursor(c.P2)
+	} else {
+		routine.cursors[c.P1] = vm.kv.NewSnapshotCursor(c.P2)
+	}
 	return cmdRes{}
 }
 
@@ -428,11 +663,11 @@ type ColumnCmd cmd
 
 func (c *ColumnCmd) execute(vm *vm, routine *routine) cmdRes {
 	v := routine.cursors[c.P1].GetValue()
-	cols, err := kv.Decode(v)
+	col, err := vm.kv.DecodeColumn(v, c.P2)
 	if err != nil {
 		return cmdRes{err: err}
 	}
-	routine.registers[c.P3] = cols[c.P2]
+	routine.registers[c.P3] = col
 	return cmdRes{}
 }
 
@@ -462,6 +697,12 @@ func (c *ResultRowCmd) execute(vm *vm, routine *routine) cmdRes {
 			return cmdRes{err: fmt.Errorf("unhandled result row %#v", v)}
 		}
 	}
+	if routine.onResultRow != nil {
+		if err := routine.onResultRow(row); err != nil {
+			return cmdRes{err: err}
+		}
+		return cmdRes{}
+	}
 	*routine.resultRows = append(*routine.resultRows, row)
 	return cmdRes{}
 }
@@ -512,7 +753,7 @@ func (c *MakeRecordCmd) execute(vm *vm, routine *routine) cmdRes {
 	for i := c.P1; i < c.P1+c.P2; i += 1 {
 		span = append(span, routine.registers[i])
 	}
-	v, err := kv.Encode(span)
+	v, err := vm.kv.Encode(span)
 	if err != nil {
 		return cmdRes{err: err}
 	}
@@ -592,6 +833,31 @@ func (c *SeekRowId) explain(addr int) []*string {
 	return formatExplain(addr, "SeekRowID", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
 }
 
+// SeekGtCmd moves cursor P1 to the first row with a row id greater than the
+// value in register P3. If there is no such record it jumps to P2.
+type SeekGtCmd cmd
+
+func (c *SeekGtCmd) execute(vm *vm, routine *routine) cmdRes {
+	key, err := kv.EncodeKey(routine.registers[c.P3])
+	if err != nil {
+		return cmdRes{
+			err: err,
+		}
+	}
+	found := routine.cursors[c.P1].GotoKeyGt(key)
+	if !found {
+		return cmdRes{
+			nextAddress: c.P2,
+		}
+	}
+	return cmdRes{}
+}
+
+func (c *SeekGtCmd) explain(addr int) []*string {
+	comment := fmt.Sprintf("Move cursor %d to first row greater than register[%d] or jump to addr[%d]", c.P1, c.P3, c.P2)
+	return formatExplain(addr, "SeekGT", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
 // InsertCmd write to cursor P1 with data in P2 and key in P3
 type InsertCmd cmd
 
@@ -614,7 +880,11 @@ func (c *InsertCmd) execute(vm *vm, routine *routine) cmdRes {
 			err: fmt.Errorf("failed to convert %v to byte slice", bp2),
 		}
 	}
-	routine.cursors[c.P1].Set(bp3, bp2)
+	if err := routine.cursors[c.P1].Set(bp3, bp2); err != nil {
+		return cmdRes{
+			err: err,
+		}
+	}
 	return cmdRes{}
 }
 
@@ -623,6 +893,61 @@ func (c *InsertCmd) explain(addr int) []*string {
 	return formatExplain(addr, "Insert", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
 }
 
+// BatchInsertCmd inserts P5 rows into cursor P1. The row keys are in registers
+// P2 through P2+P5-1 and the corresponding records in registers P3 through
+// P3+P5-1. The rows are handed to the kv layer as one batch costing one tree
+// descent per target leaf instead of one per row.
+type BatchInsertCmd cmd
+
+func (c *BatchInsertCmd) execute(vm *vm, routine *routine) cmdRes {
+	entries := make([]kv.BatchEntry, c.P5)
+	seen := make(map[int]struct{}, c.P5)
+	for i := 0; i < c.P5; i += 1 {
+		ki, err := anyToInt(routine.registers[c.P2+i])
+		if err != nil {
+			return cmdRes{
+				err: err,
+			}
+		}
+		// A duplicate key within the statement is a constraint violation the
+		// per row NotExists check cannot see since no row is inserted until
+		// here.
+		if _, dupe := seen[ki]; dupe {
+			return cmdRes{
+				err: fmt.Errorf("pk unique constraint violated"),
+			}
+		}
+		seen[ki] = struct{}{}
+		key, err := kv.EncodeKey(ki)
+		if err != nil {
+			return cmdRes{
+				err: err,
+			}
+		}
+		value, ok := routine.registers[c.P3+i].([]byte)
+		if !ok {
+			return cmdRes{
+				err: fmt.Errorf("failed to convert %v to byte slice", routine.registers[c.P3+i]),
+			}
+		}
+		entries[i] = kv.BatchEntry{Key: key, Value: value}
+	}
+	if err := routine.cursors[c.P1].SetBatch(entries); err != nil {
+		return cmdRes{
+			err: err,
+		}
+	}
+	return cmdRes{}
+}
+
+func (c *BatchInsertCmd) explain(addr int) []*string {
+	comment := fmt.Sprintf(
+		"Insert %d rows into cursor %d with keys in registers[%d..%d] and values in registers[%d..%d]",
+		c.P5, c.P1, c.P2, c.P2+c.P5-1, c.P3, c.P3+c.P5-1,
+	)
+	return formatExplain(addr, "BatchInsert", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
 // DeleteCmd deletes the row that cursor P1 is pointing to. The cursor state
 // will be left in the "next" position meaning a call to Next will safely
 // execute. However, not calling next may have consequences since the cursor has
@@ -631,7 +956,11 @@ func (c *InsertCmd) explain(addr int) []*string {
 type DeleteCmd cmd
 
 func (c *DeleteCmd) execute(vm *vm, routine *routine) cmdRes {
-	routine.cursors[c.P1].DeleteCurrent()
+	if err := routine.cursors[c.P1].DeleteCurrent(); err != nil {
+		return cmdRes{
+			err: err,
+		}
+	}
 	return cmdRes{}
 }
 
@@ -655,6 +984,36 @@ func (c *ParseSchemaCmd) explain(addr int) []*string {
 	return formatExplain(addr, "ParseSchema", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
 }
 
+// VacuumCmd compacts the database file by rewriting every B tree
+type VacuumCmd cmd
+
+func (c *VacuumCmd) execute(vm *vm, routine *routine) cmdRes {
+	err := vm.kv.Vacuum()
+	return cmdRes{
+		err: err,
+	}
+}
+
+func (c *VacuumCmd) explain(addr int) []*string {
+	comment := "Rewrite b trees to compact the file"
+	return formatExplain(addr, "Vacuum", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
+// AnalyzeCmd gathers table statistics for the query planner
+type AnalyzeCmd cmd
+
+func (c *AnalyzeCmd) execute(vm *vm, routine *routine) cmdRes {
+	err := vm.kv.Analyze()
+	return cmdRes{
+		err: err,
+	}
+}
+
+func (c *AnalyzeCmd) explain(addr int) []*string {
+	comment := "Gather table statistics"
+	return formatExplain(addr, "Analyze", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
+}
+
 // StringCmd stores string P4 in register P1
 type StringCmd cmd
 
@@ -805,12 +1164,14 @@ func (c *CopyCmd) explain(addr int) []*string {
 	return formatExplain(addr, "Copy", c.P1, c.P2, c.P3, c.P4, c.P5, comment)
 }
 
-// CountCmd Stores the number of entries for cursor P1 in register P2.
+// CountCmd Stores the number of entries for cursor P1 in register P2. The
+// count partitions the btree across worker goroutines when the cursor
+// supports it.
 type CountCmd cmd
 
 func (c *CountCmd) execute(vm *vm, routine *routine) cmdRes {
 	cr := routine.cursors[c.P1]
-	co := cr.Count()
+	co := cr.ParallelCount()
 	routine.registers[c.P2] = co
 	return cmdRes{}
 }
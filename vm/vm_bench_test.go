@@ -0,0 +1,37 @@
+package vm
+
+import (
+	"testing"
+
+	"github.com/chirst/cdb/kv"
+)
+
+// BenchmarkDispatch measures the overhead of the command loop by running a
+// counting loop of register only commands so no pager or kv work is involved.
+func BenchmarkDispatch(b *testing.B) {
+	store, err := kv.New(true, "")
+	if err != nil {
+		b.Fatal(err)
+	}
+	vm := New(store)
+	iterations := 1_000
+	ep := NewExecutionPlan(store.GetCatalog().GetVersion(), false, false)
+	ep.Commands = []Command{
+		&InitCmd{P2: 1},
+		&IntegerCmd{P1: 0, P2: 1},
+		&IntegerCmd{P1: iterations, P2: 2},
+		&IntegerCmd{P1: 1, P2: 3},
+		&AddCmd{P1: 1, P2: 3, P3: 1},
+		&GteCmd{P1: 1, P2: 7, P3: 2},
+		&GotoCmd{P2: 4},
+		&HaltCmd{},
+	}
+	ep.MaxRegister = 3
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i += 1 {
+		if res := vm.Execute(ep, []any{}); res.Err != nil {
+			b.Fatal(res.Err)
+		}
+	}
+}
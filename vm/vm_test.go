@@ -14,7 +14,7 @@ func TestExec(t *testing.T) {
 		log.Fatal(err)
 	}
 	vm := New(kv)
-	ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false)
+	ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false, false)
 	ep.Commands = []Command{
 		&InitCmd{P2: 1},
 		&TransactionCmd{},
@@ -40,7 +40,7 @@ func TestExecReturnsVersionErr(t *testing.T) {
 	vm := New(kv)
 
 	t.Run("for read", func(t *testing.T) {
-		ep := NewExecutionPlan("FakeVersion", false)
+		ep := NewExecutionPlan("FakeVersion", false, false)
 		ep.Commands = []Command{
 			&InitCmd{P2: 1},
 			&TransactionCmd{P2: 0},
@@ -54,7 +54,7 @@ func TestExecReturnsVersionErr(t *testing.T) {
 	})
 
 	t.Run("for write", func(t *testing.T) {
-		ep := NewExecutionPlan("FakeVersion", false)
+		ep := NewExecutionPlan("FakeVersion", false, false)
 		ep.Commands = []Command{
 			&InitCmd{P2: 1},
 			&TransactionCmd{P2: 1},
@@ -118,7 +118,7 @@ func TestAddAffinity(t *testing.T) {
 				log.Fatal(err)
 			}
 			vm := New(kv)
-			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false)
+			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false, false)
 			ep.Commands = []Command{
 				&InitCmd{P2: 1},
 				c.leftRegister,
@@ -178,7 +178,7 @@ func TestNeAffinity(t *testing.T) {
 				log.Fatal(err)
 			}
 			vm := New(kv)
-			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false)
+			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false, false)
 			ep.Commands = []Command{
 				&InitCmd{P2: 1},
 				c.leftRegister,
@@ -254,7 +254,7 @@ func TestGteAffinity(t *testing.T) {
 				log.Fatal(err)
 			}
 			vm := New(kv)
-			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false)
+			ep := NewExecutionPlan(kv.GetCatalog().GetVersion(), false, false)
 			ep.Commands = []Command{
 				&InitCmd{P2: 1},
 				c.leftRegister,